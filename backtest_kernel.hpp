@@ -0,0 +1,183 @@
+#ifndef BACKTEST_KERNEL_HPP
+#define BACKTEST_KERNEL_HPP
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+#include "candle_columns.hpp"
+#include "market_universe.hpp"
+#include "signal_scan.hpp"
+#include "trading_engine.hpp"
+
+/**
+ * @file backtest_kernel.hpp
+ * @brief Quiet single-session backtest over SoA columns
+ * 
+ * Batch runs (sweeps, walk-forward) evaluate thousands of configurations
+ * per session. TradingEngine formats and prints every candle; this kernel
+ * runs the same decision sequence with no logging and no string work,
+ * reading the slow EMA from a precomputed (cached) series.
+ * 
+ * EQUIVALENCE:
+ * Per candle, in engine order: strategy state machine → exit checks
+ * (SL, TP, market close) → entry on signal → end-of-data square-off.
+ * Trades and final capital match TradingEngine<TwoCandelPatternStrategy,
+ * RiskManager> bit for bit for the same parameters.
+ */
+
+/**
+ * @brief Full parameter set for one backtest configuration
+ */
+struct BacktestConfig {
+    StrategyParams strategy;
+    RiskParams risk;                    // Includes the square-off time
+};
+
+/**
+ * @brief Outcome of one (configuration, session) run
+ */
+struct RunSummary {
+    double initial_capital = 0.0;
+    double final_capital = 0.0;
+    int trades = 0;
+    int wins = 0;
+    int losses = 0;
+    double max_drawdown = 0.0;  // Peak-to-trough of realized capital (currency)
+    
+    double pnl() const { return final_capital - initial_capital; }
+};
+
+/**
+ * @brief Run one session from its precomputed signal candles
+ * @param signals Candle indices where the strategy signals, ascending
+ *        (SignalScanner / GapLaneScanner output for config's parameters)
+ * @param trade_pnls Optional sink for realized PnL of each closed trade
+ * 
+ * An open position jumps straight to its exit candle: SL / TP become
+ * trigger prices at entry and the candles in between are skipped with
+ * vector searches (findFirstOutside, findFirstAtLeast).
+ */
+inline RunSummary runSignalBacktest(const CandleColumns& columns,
+                                    const std::vector<std::uint32_t>& signals,
+                                    double capital, const BacktestConfig& config,
+                                    std::vector<double>* trade_pnls = nullptr) {
+    RunSummary summary;
+    summary.initial_capital = capital;
+    summary.final_capital = capital;
+    
+    const std::size_t n = columns.size();
+    if (n == 0 || signals.empty()) return summary;
+    
+    const double* close = columns.close.data();
+    const int* minute = columns.minute.data();
+    const double stop_loss = capital * config.risk.stop_loss_pct;
+    const double take_profit = capital * config.risk.take_profit_pct;
+    
+    double current_capital = capital;
+    double peak_capital = capital;
+    int trades = 0;
+    
+    auto recordExit = [&](double pnl) {
+        current_capital += pnl;
+        summary.wins += pnl > 0;
+        summary.losses += pnl < 0;
+        peak_capital = std::max(peak_capital, current_capital);
+        summary.max_drawdown = std::max(summary.max_drawdown, peak_capital - current_capital);
+        if (trade_pnls) trade_pnls->push_back(pnl);
+    };
+    
+    std::size_t next_signal = 0;
+    while (next_signal < signals.size() && trades < config.risk.max_daily_trades) {
+        const std::size_t entry = signals[next_signal++];
+        const double entry_price = close[entry];
+        const int quantity = entry_price > 0
+            ? static_cast<int>(current_capital / entry_price) : 0;
+        if (quantity <= 0) continue;
+        ++trades;
+        
+        // SL / TP become trigger prices on close; jump between candidates
+        // (widened by a hair against rounding) and confirm each with the
+        // exact P&L test
+        const double stop_price = entry_price + stop_loss / quantity;
+        const double target_price = entry_price - take_profit / quantity;
+        const double slack = 1e-9 * (std::abs(stop_price) + std::abs(target_price));
+        std::size_t j = entry + 1;
+        for (;; ++j) {
+            j = findFirstOutside(close, j, n, target_price + slack, stop_price - slack);
+            if (j >= n) break;
+            const double unrealized = (entry_price - close[j]) * quantity;
+            if (unrealized <= -stop_loss || unrealized >= take_profit) break;
+        }
+        
+        // Market close wins only strictly before that candle (SL / TP are
+        // checked first on a shared candle)
+        const std::size_t cutoff = findFirstAtLeast(minute, entry + 1, j,
+                                                    config.risk.market_close_minute);
+        const bool session_over = cutoff < j;
+        if (session_over) j = cutoff;
+        
+        if (j >= n) {
+            // Square off at end of data
+            recordExit((entry_price - close[n - 1]) * quantity);
+            break;
+        }
+        recordExit((entry_price - close[j]) * quantity);
+        if (session_over) break;
+        
+        // Signals while the position was open were skipped; an exit and a
+        // new entry may share candle j (exits are checked first)
+        while (next_signal < signals.size() && signals[next_signal] < j) ++next_signal;
+    }
+    
+    summary.trades = trades;
+    summary.final_capital = current_capital;
+    return summary;
+}
+
+/**
+ * @brief Run one session
+ * @param columns Session candles as SoA columns
+ * @param ema_slow EMA(config.strategy.ema_slow_period) of close, one per candle
+ * @param trade_pnls Optional sink for realized PnL of each closed trade
+ * @param scan_start First candle that can qualify (SessionIndex::scanStart)
+ * 
+ * Signals come from the vectorised pre-scan (signal_scan.hpp). Sessions
+ * without a gap-up candle cost one vector pass.
+ */
+inline RunSummary runSessionBacktest(const CandleColumns& columns, const double* ema_slow,
+                                     double previous_day_close, double capital,
+                                     const BacktestConfig& config,
+                                     std::vector<double>* trade_pnls = nullptr,
+                                     std::size_t scan_start = 0) {
+    thread_local SignalScanner scanner;
+    thread_local std::vector<std::uint32_t> signals;
+    signals.clear();
+    if (columns.size() > 0) {
+        scanner.scan(columns, ema_slow, previous_day_close,
+                     config.strategy.gap_threshold, signals, scan_start);
+    }
+    return runSignalBacktest(columns, signals, capital, config, trade_pnls);
+}
+
+/**
+ * @brief Run one universe session, pre-screened by its SessionIndex
+ * 
+ * A session that cannot gap up at config's threshold returns a flat
+ * summary without touching candles; ema_slow may then be null.
+ */
+inline RunSummary runSessionBacktest(const MarketSession& session, const double* ema_slow,
+                                     const BacktestConfig& config,
+                                     std::vector<double>* trade_pnls = nullptr) {
+    const double gap = config.strategy.gap_threshold;
+    if (!session.index.canGapUp(gap)) {
+        RunSummary flat;
+        flat.initial_capital = session.data.capital;
+        flat.final_capital = session.data.capital;
+        return flat;
+    }
+    return runSessionBacktest(session.columns, ema_slow, session.data.previous_day_close,
+                              session.data.capital, config, trade_pnls,
+                              session.index.scanStart(gap));
+}
+
+#endif // BACKTEST_KERNEL_HPP
@@ -0,0 +1,127 @@
+#ifndef BINARY_IO_HPP
+#define BINARY_IO_HPP
+
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <utility>
+
+/**
+ * @file binary_io.hpp
+ * @brief Minimal native-endian binary encoding shared by snapshot formats
+ * 
+ * Used by checkpoints and the indicator series cache. Not intended for
+ * cross-platform exchange.
+ */
+
+/**
+ * @class BinaryWriter
+ * @brief Append-only byte buffer for trivially copyable fields and strings
+ */
+class BinaryWriter {
+private:
+    std::string buffer_;
+    
+public:
+    template <typename T>
+    void write(const T& value) {
+        static_assert(std::is_trivially_copyable<T>::value, "POD fields only");
+        buffer_.append(reinterpret_cast<const char*>(&value), sizeof(T));
+    }
+    
+    void writeString(const std::string& str) {
+        write(static_cast<std::uint32_t>(str.size()));
+        buffer_.append(str);
+    }
+    
+    void writeBytes(const char* data, std::size_t n) { buffer_.append(data, n); }
+    
+    const std::string& data() const { return buffer_; }
+    std::string release() { return std::move(buffer_); }
+};
+
+/**
+ * @class BinaryReader
+ * @brief Bounds-checked reader over a snapshot buffer
+ */
+class BinaryReader {
+private:
+    const std::string& buffer_;
+    std::size_t pos_;
+    
+    void require(std::size_t n) const {
+        if (buffer_.size() - pos_ < n) {
+            throw std::runtime_error("Truncated snapshot");
+        }
+    }
+    
+public:
+    explicit BinaryReader(const std::string& buffer) : buffer_(buffer), pos_(0) {}
+    
+    template <typename T>
+    T read() {
+        static_assert(std::is_trivially_copyable<T>::value, "POD fields only");
+        require(sizeof(T));
+        T value;
+        std::memcpy(&value, buffer_.data() + pos_, sizeof(T));
+        pos_ += sizeof(T);
+        return value;
+    }
+    
+    std::string readString() {
+        std::uint32_t len = read<std::uint32_t>();
+        require(len);
+        std::string str(buffer_.data() + pos_, len);
+        pos_ += len;
+        return str;
+    }
+    
+    /**
+     * @brief Read an element count of type T, checked against the bytes left
+     * @param min_record_bytes Smallest encoding of one element (> 0)
+     * 
+     * A corrupt count throws here instead of sizing a huge allocation.
+     */
+    template <typename T>
+    std::size_t readCount(std::size_t min_record_bytes) {
+        const std::uint64_t count = read<T>();
+        if (count > remaining() / min_record_bytes) {
+            throw std::runtime_error("Truncated snapshot");
+        }
+        return static_cast<std::size_t>(count);
+    }
+    
+    void readBytes(char* out, std::size_t n) {
+        require(n);
+        std::memcpy(out, buffer_.data() + pos_, n);
+        pos_ += n;
+    }
+    
+    std::size_t remaining() const { return buffer_.size() - pos_; }
+    bool atEnd() const { return pos_ == buffer_.size(); }
+};
+
+/**
+ * @brief Read a whole file into memory (binary)
+ */
+inline std::string readBinaryFile(const std::string& filename) {
+    std::ifstream file(filename, std::ios::binary);
+    if (!file.is_open()) {
+        throw std::runtime_error("Cannot open file: " + filename);
+    }
+    return std::string((std::istreambuf_iterator<char>(file)),
+                       std::istreambuf_iterator<char>());
+}
+
+inline void writeBinaryFile(const std::string& filename, const std::string& data) {
+    std::ofstream file(filename, std::ios::binary);
+    if (!file.is_open()) {
+        throw std::runtime_error("Cannot write file: " + filename);
+    }
+    file.write(data.data(), static_cast<std::streamsize>(data.size()));
+}
+
+#endif // BINARY_IO_HPP
@@ -0,0 +1,108 @@
+#ifndef CANDLE_COLUMNS_HPP
+#define CANDLE_COLUMNS_HPP
+
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+#include "trading_engine.hpp"
+
+/**
+ * @file candle_columns.hpp
+ * @brief Structure-of-arrays view of a session's candles
+ * 
+ * Batch kernels (series indicators, scans) stream one field at a time.
+ * Candle is array-of-structs with a std::string timestamp in every element,
+ * so a pass over `low` would drag the whole record through cache. The
+ * columns here are contiguous doubles, with timestamps pre-parsed to
+ * minutes since midnight.
+ */
+
+/**
+ * @brief Parse "HH:MM" to minutes since midnight
+ */
+inline int parseMinuteOfDay(const std::string& time_str) {
+    int hours = std::stoi(time_str.substr(0, 2));
+    int minutes = std::stoi(time_str.substr(3, 2));
+    return hours * 60 + minutes;
+}
+
+/**
+ * @brief Format minutes since midnight as "HH:MM"
+ */
+inline std::string formatMinuteOfDay(int minute_of_day) {
+    char buf[6];
+    buf[0] = static_cast<char>('0' + (minute_of_day / 600) % 10);
+    buf[1] = static_cast<char>('0' + (minute_of_day / 60) % 10);
+    buf[2] = ':';
+    buf[3] = static_cast<char>('0' + (minute_of_day % 60) / 10);
+    buf[4] = static_cast<char>('0' + minute_of_day % 10);
+    buf[5] = '\0';
+    return std::string(buf, 5);
+}
+
+/**
+ * @struct CandleColumns
+ * @brief One contiguous column per candle field
+ */
+struct CandleColumns {
+    std::vector<double> open;
+    std::vector<double> high;
+    std::vector<double> low;
+    std::vector<double> close;
+    std::vector<double> volume;
+    std::vector<int> minute;  // Minutes since midnight
+    std::uint64_t fingerprint = 0;  // Hash of the price columns (fromCandles)
+    
+    std::size_t size() const { return close.size(); }
+    bool empty() const { return close.empty(); }
+    
+    const std::vector<double>& column(PriceSource source) const {
+        switch (source) {
+            case PriceSource::OPEN:  return open;
+            case PriceSource::HIGH:  return high;
+            case PriceSource::LOW:   return low;
+            case PriceSource::CLOSE: return close;
+        }
+        return close;
+    }
+    
+    /**
+     * @brief FNV-1a over the OHLC columns; changes whenever a price does
+     */
+    std::uint64_t hashPrices() const {
+        std::uint64_t hash = 14695981039346656037ULL;
+        for (const std::vector<double>* col : {&open, &high, &low, &close}) {
+            for (double value : *col) {
+                std::uint64_t bits;
+                std::memcpy(&bits, &value, sizeof(bits));
+                hash = (hash ^ bits) * 1099511628211ULL;
+            }
+        }
+        return hash;
+    }
+    
+    static CandleColumns fromCandles(const std::vector<Candle>& candles) {
+        CandleColumns cols;
+        const std::size_t n = candles.size();
+        cols.open.reserve(n);
+        cols.high.reserve(n);
+        cols.low.reserve(n);
+        cols.close.reserve(n);
+        cols.volume.reserve(n);
+        cols.minute.reserve(n);
+        
+        for (const auto& candle : candles) {
+            cols.open.push_back(candle.open);
+            cols.high.push_back(candle.high);
+            cols.low.push_back(candle.low);
+            cols.close.push_back(candle.close);
+            cols.volume.push_back(candle.volume);
+            cols.minute.push_back(parseMinuteOfDay(candle.timestamp));
+        }
+        cols.fingerprint = cols.hashPrices();
+        return cols;
+    }
+};
+
+#endif // CANDLE_COLUMNS_HPP
@@ -0,0 +1,357 @@
+#include <atomic>
+#include <cstdio>
+#include <iostream>
+#include <random>
+#include <thread>
+#include "checkpoint.hpp"
+#include "historical_var.hpp"
+#include "intrabar_exit.hpp"
+#include "market_universe.hpp"
+#include "multi_strategy_host.hpp"
+#include "order_book.hpp"
+#include "portfolio_risk.hpp"
+#include "resampler.hpp"
+#include "trading_engine.hpp"
+
+/**
+ * @file check.cpp
+ * @brief Self-check driver for `make check`
+ *
+ * Compiles the library headers main.cpp does not include and asserts the
+ * properties they promise on synthetic sessions. Prints each failed
+ * condition and exits non-zero if any failed.
+ */
+
+static int failures = 0;
+
+#define CHECK(condition)                                                       \
+    do {                                                                       \
+        if (!(condition)) {                                                    \
+            std::fprintf(stderr, "%s:%d: CHECK failed: %s\n",                  \
+                         __FILE__, __LINE__, #condition);                      \
+            ++failures;                                                        \
+        }                                                                      \
+    } while (0)
+
+/**
+ * @brief Silences engine console output for the lifetime of the guard
+ */
+struct QuietOutput {
+    QuietOutput() { std::cout.setstate(std::ios::failbit); }
+    ~QuietOutput() { std::cout.clear(); }
+};
+
+/**
+ * @brief Random-walk 5-minute session, 09:15 to 15:15, priced in 0.05 ticks
+ *
+ * A third of the sessions gap up at the open so the pattern strategy trades.
+ */
+static MarketData syntheticSession(std::mt19937_64& rng, int index) {
+    std::uniform_real_distribution<double> noise(-1.0, 1.0);
+    auto tick = [](double price) { return std::round(price * 20.0) / 20.0; };
+
+    MarketData data;
+    data.instrument = "SYM" + std::to_string(index % 3);
+    data.session = "2024-01-" + std::string(index / 3 < 9 ? "0" : "") + std::to_string(index / 3 + 1);
+    data.capital = 100000;
+    data.previous_day_close = 100;
+
+    double price = 100 * (1 + (rng() % 3 == 0 ? 0.02 + 0.04 * std::abs(noise(rng))
+                                                : 0.01 * noise(rng)));
+    for (int minute = 555; minute <= 915; minute += 5) {
+        const double open = tick(price);
+        const double close = tick(open * (1 + 0.006 * noise(rng)));
+        const double high = std::max({tick(std::max(open, close) * (1 + 0.003 * std::abs(noise(rng)))),
+                                      open, close});
+        const double low = std::min({tick(std::min(open, close) * (1 - 0.003 * std::abs(noise(rng)))),
+                                     open, close});
+        data.candles.emplace_back(formatMinuteOfDay(minute), open, high, low, close, 1000);
+        price = close;
+    }
+    return data;
+}
+
+static bool sameTrades(const std::vector<Trade>& a, const std::vector<Trade>& b) {
+    if (a.size() != b.size()) return false;
+    for (std::size_t t = 0; t < a.size(); ++t) {
+        if (a[t].timestamp != b[t].timestamp || a[t].side != b[t].side ||
+            a[t].type != b[t].type || a[t].price != b[t].price ||
+            a[t].quantity != b[t].quantity || a[t].pnl != b[t].pnl) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief MultiStrategyHost reproduces one TradingEngine per configuration
+ */
+static void checkMultiStrategyHost(const std::vector<MarketData>& sessions) {
+    std::vector<BacktestConfig> configs;
+    for (double gap : {0.0, 0.02}) {
+        for (int slow : {3, 8}) {
+            for (double stop : {0.005, 0.02}) {
+                for (int close_minute : {600, 900}) {
+                    BacktestConfig config;
+                    config.strategy.gap_threshold = gap;
+                    config.strategy.ema_slow_period = slow;
+                    config.risk.stop_loss_pct = stop;
+                    config.risk.take_profit_pct = 0.01;
+                    config.risk.max_daily_trades = 2;
+                    config.risk.market_close_minute = close_minute;
+                    configs.push_back(config);
+                }
+            }
+        }
+    }
+
+    MultiStrategyHost host(configs);
+    std::size_t trades = 0;
+    for (const MarketData& data : sessions) {
+        host.runSession(data);
+        for (std::size_t k = 0; k < configs.size(); ++k) {
+            QuietOutput quiet;
+            TradingEngine<> engine(data, TwoCandelPatternStrategy(configs[k].strategy),
+                                   RiskManager(data.capital, configs[k].risk));
+            engine.run();
+            CHECK(sameTrades(host.getTradeLog(k), engine.getTradeLog()));
+            trades += engine.getTradeLog().size();
+        }
+    }
+    CHECK(trades > 0);
+}
+
+/**
+ * @brief An engine restored from a mid-session checkpoint finishes like the original
+ */
+static void checkCheckpointFork(const std::vector<MarketData>& sessions) {
+    QuietOutput quiet;
+    for (const MarketData& data : sessions) {
+        TradingEngine<> full(data);
+        full.run();
+
+        for (std::size_t cut : {std::size_t(1), data.candles.size() / 3, data.candles.size() - 1}) {
+            TradingEngine<> original(data);
+            original.begin();
+            original.advanceTo(cut);
+            const std::string snapshot = saveCheckpoint(original);
+
+            TradingEngine<> fork(data);
+            restoreCheckpoint(fork, snapshot);
+            fork.resume();
+            original.resume();
+            CHECK(sameTrades(fork.getTradeLog(), full.getTradeLog()));
+            CHECK(sameTrades(original.getTradeLog(), full.getTradeLog()));
+
+            TradingEngine<> truncated(data);
+            bool rejected = false;
+            try {
+                restoreCheckpoint(truncated, snapshot.substr(0, snapshot.size() / 2));
+            } catch (const std::runtime_error&) {
+                rejected = true;
+            }
+            CHECK(rejected);
+        }
+    }
+}
+
+/**
+ * @brief Concurrent reserve/release never overshoots a PortfolioRisk limit
+ */
+static void checkPortfolioRisk() {
+    constexpr unsigned THREADS = 8;
+    constexpr int ATTEMPTS = 4000;
+    PortfolioLimits limits;
+    limits.max_gross_exposure = 20000;
+    limits.max_daily_loss = 1500;
+    limits.max_trades = 6000;
+    PortfolioRisk portfolio(limits);
+
+    std::atomic<int> accepted{0};
+    std::atomic<bool> overshoot{false};
+    std::vector<std::thread> workers;
+    for (unsigned w = 0; w < THREADS; ++w) {
+        workers.emplace_back([&, w] {
+            std::mt19937_64 rng(w);
+            std::vector<PortfolioTicket> open;
+            for (int i = 0; i < ATTEMPTS; ++i) {
+                PortfolioTicket ticket;
+                if (portfolio.reserve(1000.0, 100.0, ticket) == PortfolioRisk::Rejection::NONE) {
+                    accepted.fetch_add(1);
+                    open.push_back(ticket);
+                }
+                if (!open.empty() && (open.size() > 3 || rng() % 2 == 0)) {
+                    portfolio.release(open.front(), 0.0);
+                    open.erase(open.begin());
+                }
+                const PortfolioRisk::Snapshot state = portfolio.snapshot();
+                if (state.gross_exposure > limits.max_gross_exposure ||
+                    state.loss_in_use > limits.max_daily_loss ||
+                    state.trades > limits.max_trades) {
+                    overshoot = true;
+                }
+            }
+            for (PortfolioTicket& ticket : open) portfolio.release(ticket, 0.0);
+        });
+    }
+    for (auto& worker : workers) worker.join();
+
+    const PortfolioRisk::Snapshot state = portfolio.snapshot();
+    CHECK(!overshoot);
+    CHECK(state.gross_exposure == 0.0);
+    CHECK(state.loss_in_use == 0.0);
+    CHECK(state.trades == accepted.load());
+    CHECK(state.trades == limits.max_trades);
+    CHECK(state.trades + static_cast<std::int64_t>(state.rejected_trades + state.rejected_exposure +
+                                                   state.rejected_loss) ==
+          static_cast<std::int64_t>(THREADS) * ATTEMPTS);
+}
+
+/**
+ * @brief Queue position of a resting order through a trade and a cancel
+ */
+static void checkOrderBookQueue() {
+    OrderBookSim book(99.0, 101.0, 0.01);
+    book.apply(BookEvent{0, BookEvent::Type::LEVEL, BookSide::BID, 100.00, 100});
+    book.apply(BookEvent{0, BookEvent::Type::LEVEL, BookSide::ASK, 100.05, 50});
+
+    const std::uint64_t id = book.submitLimit(OrderSide::BUY, 100.00, 10, 1);
+    CHECK(book.fills().empty());
+    CHECK(book.queueAhead(id) == 100);
+
+    // 30 printed ahead of us
+    book.apply(BookEvent{2, BookEvent::Type::TRADE, BookSide::BID, 100.00, 30});
+    CHECK(book.queueAhead(id) == 70);
+    CHECK(book.fills().empty());
+
+    // Depth 100 -> 50: 30 explained by the trade, 20 cancelled across the 70 ahead
+    book.apply(BookEvent{3, BookEvent::Type::LEVEL, BookSide::BID, 100.00, 50});
+    CHECK(book.queueAhead(id) == 50);
+
+    // 55 more: 50 clears the queue, 5 fill us
+    book.apply(BookEvent{4, BookEvent::Type::TRADE, BookSide::BID, 100.00, 55});
+    CHECK(book.fills().size() == 1);
+    CHECK(!book.fills().empty() && book.fills()[0].quantity == 5 && book.fills()[0].maker);
+    CHECK(book.remaining(id) == 5);
+    CHECK(book.queueAhead(id) == 0);
+
+    CHECK(book.cancel(id));
+    CHECK(!book.cancel(id));
+    CHECK(book.remaining(id) == 0);
+}
+
+/**
+ * @brief 15-minute bars equal a direct grouping of the 5-minute candles
+ */
+static void checkResampler(const MarketData& data) {
+    std::vector<Candle> bars;
+    CandleResampler resampler(15);
+    for (const Candle& candle : data.candles) {
+        resampler.update(candle, [&](const Candle& bar) { bars.push_back(bar); });
+    }
+    resampler.flush([&](const Candle& bar) { bars.push_back(bar); });
+
+    std::vector<Candle> expected;
+    int open_bucket = -1;
+    for (const Candle& candle : data.candles) {
+        const int bucket = (parseMinuteOfDay(candle.timestamp) - DEFAULT_SESSION_OPEN_MINUTE) / 15;
+        if (bucket != open_bucket) {
+            expected.push_back(candle);
+            expected.back().timestamp = formatMinuteOfDay(DEFAULT_SESSION_OPEN_MINUTE + bucket * 15);
+            open_bucket = bucket;
+            continue;
+        }
+        Candle& bar = expected.back();
+        bar.high = std::max(bar.high, candle.high);
+        bar.low = std::min(bar.low, candle.low);
+        bar.close = candle.close;
+        bar.volume += candle.volume;
+    }
+
+    CHECK(bars.size() == expected.size());
+    for (std::size_t i = 0; i < std::min(bars.size(), expected.size()); ++i) {
+        CHECK(bars[i].timestamp == expected[i].timestamp && bars[i].open == expected[i].open &&
+              bars[i].high == expected[i].high && bars[i].low == expected[i].low &&
+              bars[i].close == expected[i].close && bars[i].volume == expected[i].volume);
+    }
+}
+
+/**
+ * @brief A bar touching both triggers resolves on its sub-bars when it has them
+ */
+static void checkIntrabarExit() {
+    const std::vector<Candle> candles = {
+        Candle("09:15", 100.0, 100.2, 99.8, 100.0, 1000),
+        Candle("09:20", 100.0, 102.0, 98.0, 100.5, 1000),
+    };
+    const CandleColumns bars = CandleColumns::fromCandles(candles);
+    const TriggerPrices triggers{101.0, 99.0};
+
+    IntrabarExitEngine coarse(bars);
+    const IntrabarExit pessimistic = coarse.findExit(0, triggers, 24 * 60);
+    CHECK(pessimistic.bar == 1 && pessimistic.reason == ExitReason::STOP_LOSS);
+    CHECK(pessimistic.price == 101.0 && !pessimistic.from_fine_data);
+
+    IntrabarExitEngine fine(bars, [](std::size_t, std::vector<SubBar>& out) {
+        out.push_back(SubBar{0, 100.0, 100.3, 98.5, 98.8});
+        out.push_back(SubBar{60000, 98.8, 102.0, 98.0, 100.5});
+    });
+    const IntrabarExit resolved = fine.findExit(0, triggers, 24 * 60);
+    CHECK(resolved.bar == 1 && resolved.reason == ExitReason::TAKE_PROFIT);
+    CHECK(resolved.price == 99.0 && resolved.from_fine_data);
+    CHECK(fine.drilldowns() == 1);
+}
+
+/**
+ * @brief VaR and expected shortfall equal a full sort of the scenario P&L
+ */
+static void checkHistoricalVaR(const std::vector<MarketData>& sessions) {
+    MarketUniverse universe;
+    for (const MarketData& data : sessions) universe.add(data);
+    const ReturnMatrix matrix = ReturnMatrix::fromUniverse(universe);
+    CHECK(matrix.instruments.size() == 3);
+
+    std::vector<double> exposures;
+    for (std::size_t j = 0; j < matrix.instruments.size(); ++j) {
+        exposures.push_back(j % 2 ? 25000.0 : -40000.0);
+    }
+    std::vector<double> pnl(matrix.scenarios, 0.0);
+    for (std::size_t j = 0; j < exposures.size(); ++j) {
+        for (std::size_t t = 0; t < matrix.scenarios; ++t) {
+            pnl[t] += exposures[j] * matrix.column(j)[t];
+        }
+    }
+    std::sort(pnl.begin(), pnl.end());
+
+    HistoricalVaR var(matrix, 4);
+    const VaRResult result = var.compute(exposures, 0.95);
+    const std::size_t k = static_cast<std::size_t>(std::ceil(0.05 * static_cast<double>(pnl.size()) - 1e-9));
+    double tail = 0.0;
+    for (std::size_t t = 0; t < k; ++t) tail += pnl[t];
+
+    CHECK(result.scenarios == pnl.size());
+    CHECK(result.tail_scenarios == k);
+    CHECK(std::abs(result.value_at_risk + pnl[k - 1]) < 1e-6);
+    CHECK(std::abs(result.expected_shortfall + tail / static_cast<double>(k)) < 1e-6);
+}
+
+int main() {
+    std::mt19937_64 rng(20240101);
+    std::vector<MarketData> sessions;
+    for (int index = 0; index < 30; ++index) sessions.push_back(syntheticSession(rng, index));
+
+    checkMultiStrategyHost(sessions);
+    checkCheckpointFork(sessions);
+    checkPortfolioRisk();
+    checkOrderBookQueue();
+    checkResampler(sessions.front());
+    checkIntrabarExit();
+    checkHistoricalVaR(sessions);
+
+    if (failures > 0) {
+        std::fprintf(stderr, "%d check(s) failed\n", failures);
+        return 1;
+    }
+    std::printf("All checks passed\n");
+    return 0;
+}
@@ -0,0 +1,309 @@
+#ifndef CHECKPOINT_HPP
+#define CHECKPOINT_HPP
+
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include "binary_io.hpp"
+#include "trading_engine.hpp"
+
+/**
+ * @file checkpoint.hpp
+ * @brief Compact binary snapshots of indicator, strategy and position state
+ * 
+ * A restarted engine restores its mid-session state from a snapshot instead
+ * of replaying the session from the open. The same snapshot forks a backtest
+ * at a given candle: run the prefix once, then restore into as many engines
+ * as needed.
+ * 
+ * FORMAT (native endianness, not intended for cross-platform exchange):
+ *   magic "MECK" | u32 version | instrument | session | engine state
+ * Strings are u32 length + bytes. Fixed-size fields are raw memcpy.
+ * Element counts are checked against the bytes left before anything is
+ * allocated, so a corrupt snapshot throws std::runtime_error.
+ */
+
+constexpr char CHECKPOINT_MAGIC[4] = {'M', 'E', 'C', 'K'};
+constexpr std::uint32_t CHECKPOINT_VERSION = 4;
+
+// ============================================================================
+// COMPONENT ENCODERS
+// ============================================================================
+
+// Structs are written field by field so padding never reaches the snapshot
+
+// Flags and enums are one byte each, range-checked on read so a corrupt
+// byte throws instead of becoming an invalid bool or enum value
+
+inline void writeFlag(BinaryWriter& out, bool flag) {
+    out.write(static_cast<std::uint8_t>(flag));
+}
+
+inline bool readFlag(BinaryReader& in) {
+    const std::uint8_t byte = in.read<std::uint8_t>();
+    if (byte > 1) {
+        throw std::runtime_error("Corrupt checkpoint flag");
+    }
+    return byte != 0;
+}
+
+template <typename Enum>
+void writeEnum(BinaryWriter& out, Enum value) {
+    out.write(static_cast<std::uint8_t>(value));
+}
+
+template <typename Enum>
+Enum readEnum(BinaryReader& in, Enum last) {
+    const std::uint8_t byte = in.read<std::uint8_t>();
+    if (byte > static_cast<std::uint8_t>(last)) {
+        throw std::runtime_error("Corrupt checkpoint enum");
+    }
+    return static_cast<Enum>(byte);
+}
+
+// Smallest encoding of one element of each variable-length list
+constexpr std::size_t CHECKPOINT_ENTRY_BYTES = sizeof(std::uint64_t) + sizeof(double);
+constexpr std::size_t CHECKPOINT_NODE_BYTES =
+    sizeof(int) + sizeof(double) + sizeof(std::uint8_t) +              // EMA
+    sizeof(std::uint64_t) + sizeof(std::uint32_t) +                    // Window
+    sizeof(double) + sizeof(std::uint8_t);                             // Pending input
+constexpr std::size_t CHECKPOINT_TRADE_BYTES =
+    sizeof(std::uint32_t) + 2 * sizeof(std::uint8_t) +
+    sizeof(double) + sizeof(int) + sizeof(double);
+
+inline void writeState(BinaryWriter& out, const EMACalculator::State& state) {
+    out.write(state.period);
+    out.write(state.ema);
+    writeFlag(out, state.initialized);
+}
+
+inline void readState(BinaryReader& in, EMACalculator::State& state) {
+    state.period = in.read<int>();
+    state.ema = in.read<double>();
+    state.initialized = readFlag(in);
+}
+
+inline void writeState(BinaryWriter& out, const RollingExtreme::State& state) {
+    out.write(state.count);
+    out.write(static_cast<std::uint32_t>(state.entries.size()));
+    for (const auto& entry : state.entries) {
+        out.write(entry.index);
+        out.write(entry.value);
+    }
+}
+
+inline void readState(BinaryReader& in, RollingExtreme::State& state) {
+    state.count = in.read<std::uint64_t>();
+    state.entries.resize(in.readCount<std::uint32_t>(CHECKPOINT_ENTRY_BYTES));
+    for (auto& entry : state.entries) {
+        entry.index = in.read<std::uint64_t>();
+        entry.value = in.read<double>();
+    }
+}
+
+inline void writeState(BinaryWriter& out, const IndicatorRegistry::State& state) {
+    out.write(static_cast<std::uint32_t>(state.size()));
+    for (const auto& node : state) {
+        writeState(out, node.ema);
+        writeState(out, node.window);
+        out.write(node.pending);
+        writeFlag(out, node.has_pending);
+    }
+}
+
+inline void readState(BinaryReader& in, IndicatorRegistry::State& state) {
+    state.resize(in.readCount<std::uint32_t>(CHECKPOINT_NODE_BYTES));
+    for (auto& node : state) {
+        readState(in, node.ema);
+        readState(in, node.window);
+        node.pending = in.read<double>();
+        node.has_pending = readFlag(in);
+    }
+}
+
+inline void writeState(BinaryWriter& out, const Candle& candle) {
+    out.writeString(candle.timestamp);
+    out.write(candle.open);
+    out.write(candle.high);
+    out.write(candle.low);
+    out.write(candle.close);
+    out.write(candle.volume);
+}
+
+inline void readState(BinaryReader& in, Candle& candle) {
+    candle.timestamp = in.readString();
+    candle.open = in.read<double>();
+    candle.high = in.read<double>();
+    candle.low = in.read<double>();
+    candle.close = in.read<double>();
+    candle.volume = in.read<double>();
+}
+
+inline void writeState(BinaryWriter& out, const TwoCandelPatternStrategy::State& state) {
+    writeState(out, state.first_candle);
+    writeFlag(out, state.first_candle_valid);
+    out.write(state.previous_day_close);
+    writeState(out, state.ema3);
+    writeState(out, state.ema5);
+}
+
+inline void readState(BinaryReader& in, TwoCandelPatternStrategy::State& state) {
+    readState(in, state.first_candle);
+    state.first_candle_valid = readFlag(in);
+    state.previous_day_close = in.read<double>();
+    readState(in, state.ema3);
+    readState(in, state.ema5);
+}
+
+inline void writeState(BinaryWriter& out, const Position& position) {
+    writeFlag(out, position.is_open);
+    writeEnum(out, position.side);
+    out.write(position.entry_price);
+    out.write(position.quantity);
+    out.writeString(position.entry_timestamp);
+}
+
+inline void readState(BinaryReader& in, Position& position) {
+    position.is_open = readFlag(in);
+    position.side = readEnum(in, Trade::Side::SELL);
+    position.entry_price = in.read<double>();
+    position.quantity = in.read<int>();
+    position.entry_timestamp = in.readString();
+}
+
+inline void writeState(BinaryWriter& out, const Trade& trade) {
+    out.writeString(trade.timestamp);
+    writeEnum(out, trade.side);
+    writeEnum(out, trade.type);
+    out.write(trade.price);
+    out.write(trade.quantity);
+    out.write(trade.pnl);
+}
+
+inline Trade readTrade(BinaryReader& in) {
+    std::string ts = in.readString();
+    Trade::Side side = readEnum(in, Trade::Side::SELL);
+    Trade::Type type = readEnum(in, Trade::Type::EXIT);
+    double price = in.read<double>();
+    int quantity = in.read<int>();
+    double pnl = in.read<double>();
+    return Trade(ts, side, type, price, quantity, pnl);
+}
+
+inline void writeState(BinaryWriter& out, const RiskManager::State& state) {
+    out.write(state.current_capital);
+    out.write(state.trades_today);
+}
+
+inline void readState(BinaryReader& in, RiskManager::State& state) {
+    state.current_capital = in.read<double>();
+    state.trades_today = in.read<int>();
+}
+
+/**
+ * @brief Encode any engine state whose strategy/risk states have encoders
+ */
+template <typename EngineState>
+void writeEngineState(BinaryWriter& out, const EngineState& state) {
+    out.write(static_cast<std::uint64_t>(state.candle_index));
+    writeFlag(out, state.session_active);
+    writeState(out, state.strategy);
+    
+    writeState(out, state.indicators);
+    
+    writeState(out, state.risk);
+    writeState(out, state.position);
+    
+    out.write(static_cast<std::uint32_t>(state.trade_log.size()));
+    for (const auto& trade : state.trade_log) writeState(out, trade);
+}
+
+template <typename EngineState>
+void readEngineState(BinaryReader& in, EngineState& state) {
+    state.candle_index = static_cast<size_t>(in.read<std::uint64_t>());
+    state.session_active = readFlag(in);
+    readState(in, state.strategy);
+    
+    readState(in, state.indicators);
+    
+    readState(in, state.risk);
+    readState(in, state.position);
+    
+    std::size_t trade_count = in.readCount<std::uint32_t>(CHECKPOINT_TRADE_BYTES);
+    state.trade_log.clear();
+    state.trade_log.reserve(trade_count);
+    for (std::size_t i = 0; i < trade_count; ++i) {
+        state.trade_log.push_back(readTrade(in));
+    }
+}
+
+
+// ============================================================================
+// ENGINE SNAPSHOTS
+// ============================================================================
+
+/**
+ * @brief Serialise the engine's mid-session state
+ * @return Binary snapshot (a few hundred bytes plus the trade log)
+ */
+template <typename Strategy, typename Risk>
+std::string saveCheckpoint(const TradingEngine<Strategy, Risk>& engine) {
+    BinaryWriter out;
+    out.writeBytes(CHECKPOINT_MAGIC, sizeof(CHECKPOINT_MAGIC));
+    out.write(CHECKPOINT_VERSION);
+    out.writeString(engine.getMarketData().instrument);
+    out.writeString(engine.getMarketData().session);
+    writeEngineState(out, engine.getState());
+    return out.release();
+}
+
+/**
+ * @brief Restore a snapshot into an engine built on the same market data
+ * 
+ * After restoring, call engine.resume() (or advanceTo()) to continue from
+ * the snapshot candle. Throws std::runtime_error on a corrupt snapshot or
+ * an instrument or session mismatch.
+ */
+template <typename Strategy, typename Risk>
+void restoreCheckpoint(TradingEngine<Strategy, Risk>& engine, const std::string& snapshot) {
+    BinaryReader in(snapshot);
+    
+    char magic[sizeof(CHECKPOINT_MAGIC)];
+    in.readBytes(magic, sizeof(magic));
+    if (std::memcmp(magic, CHECKPOINT_MAGIC, sizeof(magic)) != 0) {
+        throw std::runtime_error("Not a trading engine checkpoint");
+    }
+    if (in.read<std::uint32_t>() != CHECKPOINT_VERSION) {
+        throw std::runtime_error("Unsupported checkpoint version");
+    }
+    
+    std::string instrument = in.readString();
+    if (instrument != engine.getMarketData().instrument) {
+        throw std::runtime_error("Checkpoint is for instrument " + instrument);
+    }
+    std::string session = in.readString();
+    if (session != engine.getMarketData().session) {
+        throw std::runtime_error("Checkpoint is for session " + session);
+    }
+    
+    typename TradingEngine<Strategy, Risk>::State state;
+    readEngineState(in, state);
+    if (!in.atEnd()) {
+        throw std::runtime_error("Trailing bytes in checkpoint");
+    }
+    engine.restoreState(state);
+}
+
+template <typename Strategy, typename Risk>
+void saveCheckpointFile(const TradingEngine<Strategy, Risk>& engine, const std::string& filename) {
+    writeBinaryFile(filename, saveCheckpoint(engine));
+}
+
+template <typename Strategy, typename Risk>
+void restoreCheckpointFile(TradingEngine<Strategy, Risk>& engine, const std::string& filename) {
+    restoreCheckpoint(engine, readBinaryFile(filename));
+}
+
+#endif // CHECKPOINT_HPP
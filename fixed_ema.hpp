@@ -0,0 +1,137 @@
+#ifndef FIXED_EMA_HPP
+#define FIXED_EMA_HPP
+
+#include <array>
+#include <cstddef>
+#include <utility>
+
+/**
+ * @file fixed_ema.hpp
+ * @brief Compile-time specialised EMA for parameter-sweep inner loops
+ * 
+ * EMACalculator keeps period and α as runtime members. When the period is
+ * known ahead of time (sweeps over a fixed set of EMA periods), FixedEMA<P>
+ * makes α and 1 - α constexpr:
+ *     ema = price * α + ema * (1 - α)
+ * 
+ * α is computed with the same expression as EMACalculator (2 / (period + 1))
+ * and the update is EMACalculator's, term for term, so all paths produce
+ * bit-identical series. That matters because the strategy compares
+ * candle.low > EMA(5).
+ */
+
+/**
+ * @class FixedEMA
+ * @brief Incremental EMA with the period fixed at compile time
+ */
+template <int Period>
+class FixedEMA {
+    static_assert(Period > 0, "EMA period must be positive");
+    
+private:
+    double ema_;
+    bool initialized_;
+    
+public:
+    static constexpr int PERIOD = Period;
+    static constexpr double ALPHA = 2.0 / (Period + 1.0);
+    static constexpr double DECAY = 1.0 - ALPHA;
+    
+    FixedEMA() : ema_(0.0), initialized_(false) {}
+    
+    void update(double price) {
+        if (!initialized_) {
+            ema_ = price;
+            initialized_ = true;
+        } else {
+            ema_ = (price * ALPHA) + (ema_ * DECAY);
+        }
+    }
+    
+    double getValue() const { return ema_; }
+    bool isInitialized() const { return initialized_; }
+    void reset() { ema_ = 0.0; initialized_ = false; }
+    
+    /**
+     * @brief Compute the full EMA series for a price column
+     * @param prices Input column (n values)
+     * @param out Output column (n values); out[0] = prices[0]
+     */
+    static void computeSeries(const double* prices, double* out, std::size_t n) {
+        if (n == 0) return;
+        double ema = prices[0];
+        out[0] = ema;
+        for (std::size_t i = 1; i < n; ++i) {
+            ema = (prices[i] * ALPHA) + (ema * DECAY);
+            out[i] = ema;
+        }
+    }
+};
+
+
+// ============================================================================
+// RUNTIME DISPATCH
+// ============================================================================
+
+using EMASeriesKernel = void (*)(const double*, double*, std::size_t);
+
+/// Periods 1..MAX_FIXED_EMA_PERIOD resolve to a FixedEMA specialisation
+constexpr int MAX_FIXED_EMA_PERIOD = 64;
+
+namespace detail {
+
+template <std::size_t... I>
+constexpr std::array<EMASeriesKernel, sizeof...(I)>
+makeEMAKernelTable(std::index_sequence<I...>) {
+    return {{ &FixedEMA<static_cast<int>(I) + 1>::computeSeries... }};
+}
+
+inline const std::array<EMASeriesKernel, MAX_FIXED_EMA_PERIOD>& emaKernelTable() {
+    static constexpr auto table =
+        makeEMAKernelTable(std::make_index_sequence<MAX_FIXED_EMA_PERIOD>{});
+    return table;
+}
+
+/**
+ * @brief Generic series kernel for periods outside the table
+ */
+inline void computeEMASeriesRuntime(int period, const double* prices,
+                                    double* out, std::size_t n) {
+    if (n == 0) return;
+    const double alpha = 2.0 / (period + 1.0);
+    const double decay = 1.0 - alpha;
+    double ema = prices[0];
+    out[0] = ema;
+    for (std::size_t i = 1; i < n; ++i) {
+        ema = (prices[i] * alpha) + (ema * decay);
+        out[i] = ema;
+    }
+}
+
+} // namespace detail
+
+/**
+ * @brief Look up the specialised series kernel for a period
+ * @return Kernel pointer, or nullptr if the period has no specialisation
+ * 
+ * Resolve once per sweep configuration, then call the pointer in the
+ * inner loop; the kernel body has α folded in as a constant.
+ */
+inline EMASeriesKernel findEMASeriesKernel(int period) {
+    if (period < 1 || period > MAX_FIXED_EMA_PERIOD) return nullptr;
+    return detail::emaKernelTable()[static_cast<std::size_t>(period - 1)];
+}
+
+/**
+ * @brief Compute an EMA series, using the specialised kernel when available
+ */
+inline void computeEMASeries(int period, const double* prices,
+                             double* out, std::size_t n) {
+    if (EMASeriesKernel kernel = findEMASeriesKernel(period)) {
+        kernel(prices, out, n);
+    } else {
+        detail::computeEMASeriesRuntime(period, prices, out, n);
+    }
+}
+
+#endif // FIXED_EMA_HPP
@@ -0,0 +1,304 @@
+#ifndef HISTORICAL_VAR_HPP
+#define HISTORICAL_VAR_HPP
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <map>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+#include "market_universe.hpp"
+#include "parallel.hpp"
+#include "trading_engine.hpp"
+
+#if defined(__AVX2__) || defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
+/**
+ * @file historical_var.hpp
+ * @brief Historical-simulation VaR and expected shortfall for open positions
+ * 
+ * RiskManager stops each trade at a fixed fraction of capital; it says
+ * nothing about how much the book as a whole can lose on a bad bar. Here
+ * every past bar of the universe is a scenario: the portfolio P&L of
+ * scenario t is the sum over instruments of exposure × return(t). VaR is
+ * the loss exceeded in only (1 - confidence) of scenarios, expected
+ * shortfall the average loss in that tail.
+ * 
+ * LAYOUT:
+ * Returns are stored column-major, one contiguous column of scenarios per
+ * instrument, so scenario P&L is a sequence of axpy passes
+ * (pnl += exposure × column) over the instruments that are actually held.
+ * Scenarios are processed in blocks that keep their P&L slice in L1, one
+ * block per parallelFor item, with SIMD multiply-adds inside a block.
+ * 
+ * Building the matrix is a one-off per history; compute() only reads it,
+ * so it can run after every bar with the current exposures.
+ */
+
+// ============================================================================
+// RETURN MATRIX
+// ============================================================================
+
+namespace historical_var_detail {
+
+/**
+ * @brief True for a YYYY-MM-DD calendar date
+ */
+inline bool isTradingDate(const std::string& date) {
+    if (date.size() != 10 || date[4] != '-' || date[7] != '-') return false;
+    for (int i : {0, 1, 2, 3, 5, 6, 8, 9}) {
+        if (date[i] < '0' || date[i] > '9') return false;
+    }
+    const int month = (date[5] - '0') * 10 + (date[6] - '0');
+    const int day = (date[8] - '0') * 10 + (date[9] - '0');
+    return month >= 1 && month <= 12 && day >= 1 && day <= 31;
+}
+
+} // namespace historical_var_detail
+
+/**
+ * @struct ReturnMatrix
+ * @brief Bar returns of every instrument over a common scenario axis
+ */
+struct ReturnMatrix {
+    std::vector<std::string> instruments;
+    std::size_t scenarios = 0;
+    std::vector<double> returns;            // Instrument j: [j * scenarios, (j + 1) * scenarios)
+    
+    const double* column(std::size_t instrument) const {
+        return returns.data() + instrument * scenarios;
+    }
+    
+    std::size_t instrumentIndex(const std::string& instrument) const {
+        auto it = std::find(instruments.begin(), instruments.end(), instrument);
+        if (it == instruments.end()) {
+            throw std::invalid_argument("Instrument not in return history: " + instrument);
+        }
+        return static_cast<std::size_t>(it - instruments.begin());
+    }
+    
+    /**
+     * @brief Close-to-close returns of every session in the universe
+     * 
+     * Each session id must be its trading date as YYYY-MM-DD; see the
+     * overload taking explicit dates for data without one.
+     */
+    static ReturnMatrix fromUniverse(const MarketUniverse& universe) {
+        std::vector<std::string> dates;
+        dates.reserve(universe.size());
+        for (const MarketSession& session : universe) dates.push_back(session.data.session);
+        return fromUniverse(universe, dates);
+    }
+    
+    /**
+     * @brief Close-to-close returns, with each session's trading date given
+     * @param dates One YYYY-MM-DD date per universe session, in universe order
+     * 
+     * Scenarios are the distinct (date, bar minute) pairs in date order,
+     * then minute order, so instruments line up bar by bar whatever order
+     * the sessions were loaded in. A session's first bar is measured from
+     * the previous day close, so overnight gaps are scenarios too. An
+     * instrument with no bar at a scenario has return 0. Throws
+     * std::invalid_argument for a malformed date (such as the file path
+     * MarketUniverse::loadFromFiles uses when a file has no session id)
+     * or for two sessions of one instrument on the same date.
+     */
+    static ReturnMatrix fromUniverse(const MarketUniverse& universe,
+                                     const std::vector<std::string>& dates) {
+        constexpr std::int64_t MINUTES_PER_DAY = 24 * 60;
+        if (dates.size() != universe.size()) {
+            throw std::invalid_argument("One date per session required");
+        }
+        
+        ReturnMatrix matrix;
+        std::map<std::string, std::size_t> instrument_ids;
+        std::map<std::string, std::int64_t> date_ids;
+        for (std::size_t s = 0; s < universe.size(); ++s) {
+            const std::string& instrument = universe[s].data.instrument;
+            if (instrument_ids.emplace(instrument, matrix.instruments.size()).second) {
+                matrix.instruments.push_back(instrument);
+            }
+            if (!historical_var_detail::isTradingDate(dates[s])) {
+                throw std::invalid_argument("Session of " + instrument +
+                                            " has no trading date (YYYY-MM-DD): " + dates[s]);
+            }
+            date_ids.emplace(dates[s], 0);
+        }
+        // YYYY-MM-DD sorts chronologically
+        std::int64_t ordinal = 0;
+        for (auto& date : date_ids) date.second = ordinal++;
+        
+        std::vector<std::int64_t> keys;
+        std::vector<std::pair<std::size_t, std::int64_t>> seen;
+        for (std::size_t s = 0; s < universe.size(); ++s) {
+            const std::int64_t day = date_ids[dates[s]];
+            seen.emplace_back(instrument_ids[universe[s].data.instrument], day);
+            for (int minute : universe[s].columns.minute) {
+                keys.push_back(day * MINUTES_PER_DAY + minute);
+            }
+        }
+        std::sort(seen.begin(), seen.end());
+        auto duplicate = std::adjacent_find(seen.begin(), seen.end());
+        if (duplicate != seen.end()) {
+            throw std::invalid_argument("Two sessions of " + matrix.instruments[duplicate->first] +
+                                        " on the same date");
+        }
+        std::sort(keys.begin(), keys.end());
+        keys.erase(std::unique(keys.begin(), keys.end()), keys.end());
+        
+        matrix.scenarios = keys.size();
+        matrix.returns.assign(matrix.instruments.size() * matrix.scenarios, 0.0);
+        for (std::size_t s = 0; s < universe.size(); ++s) {
+            const MarketSession& session = universe[s];
+            double* column = matrix.returns.data() +
+                             instrument_ids[session.data.instrument] * matrix.scenarios;
+            const std::int64_t base = date_ids[dates[s]] * MINUTES_PER_DAY;
+            const std::vector<double>& close = session.columns.close;
+            double previous = session.data.previous_day_close;
+            for (std::size_t i = 0; i < close.size(); ++i) {
+                const std::size_t t = static_cast<std::size_t>(
+                    std::lower_bound(keys.begin(), keys.end(), base + session.columns.minute[i]) -
+                    keys.begin());
+                column[t] = previous > 0 ? close[i] / previous - 1.0 : 0.0;
+                previous = close[i];
+            }
+        }
+        return matrix;
+    }
+};
+
+/**
+ * @brief Signed market value of an engine position (short: negative)
+ */
+inline double positionExposure(const Position& position, double mark_price) {
+    if (!position.is_open) return 0.0;
+    const double value = position.quantity * mark_price;
+    return position.side == Trade::Side::SELL ? -value : value;
+}
+
+// ============================================================================
+// VAR ENGINE
+// ============================================================================
+
+struct VaRResult {
+    double value_at_risk = 0.0;         // Loss at the confidence quantile (positive = loss)
+    double expected_shortfall = 0.0;    // Mean loss of the tail scenarios
+    std::size_t scenarios = 0;
+    std::size_t tail_scenarios = 0;
+};
+
+/**
+ * @class HistoricalVaR
+ * @brief Parallel scenario P&L and tail statistics over a ReturnMatrix
+ */
+class HistoricalVaR {
+private:
+    static constexpr std::size_t BLOCK = 2048;     // Scenarios per job (16 KB of P&L)
+    
+    const ReturnMatrix& matrix_;
+    unsigned threads_;
+    std::vector<double> pnl_;
+    std::vector<std::pair<const double*, double>> held_;
+    
+    /**
+     * @brief out[0, n) += exposure * column[0, n)
+     */
+    static void accumulate(double* out, const double* column, double exposure, std::size_t n) {
+        std::size_t t = 0;
+#if defined(__AVX2__)
+        const __m256d e = _mm256_set1_pd(exposure);
+        for (; t + 4 <= n; t += 4) {
+            _mm256_storeu_pd(out + t, _mm256_add_pd(_mm256_loadu_pd(out + t),
+                                                    _mm256_mul_pd(e, _mm256_loadu_pd(column + t))));
+        }
+#elif defined(__SSE2__)
+        const __m128d e = _mm_set1_pd(exposure);
+        for (; t + 2 <= n; t += 2) {
+            _mm_storeu_pd(out + t, _mm_add_pd(_mm_loadu_pd(out + t),
+                                              _mm_mul_pd(e, _mm_loadu_pd(column + t))));
+        }
+#endif
+        for (; t < n; ++t) out[t] += exposure * column[t];
+    }
+    
+public:
+    HistoricalVaR(const ReturnMatrix& matrix, unsigned threads = 0)
+        : matrix_(matrix), threads_(threads ? threads : defaultThreadCount()) {}
+    
+    /**
+     * @brief Portfolio P&L of the last `window` scenarios (0 = all)
+     * @param exposures Signed market value per matrix instrument
+     * @return One value per scenario, oldest first
+     */
+    const std::vector<double>& scenarioPnl(const std::vector<double>& exposures,
+                                           std::size_t window = 0) {
+        if (exposures.size() != matrix_.instruments.size()) {
+            throw std::invalid_argument("One exposure per instrument required");
+        }
+        const std::size_t n = window ? std::min(window, matrix_.scenarios) : matrix_.scenarios;
+        const std::size_t first = matrix_.scenarios - n;
+        
+        held_.clear();
+        for (std::size_t j = 0; j < exposures.size(); ++j) {
+            if (exposures[j] != 0.0) held_.emplace_back(matrix_.column(j) + first, exposures[j]);
+        }
+        
+        pnl_.assign(n, 0.0);
+        const std::size_t blocks = (n + BLOCK - 1) / BLOCK;
+        parallelFor(blocks, threads_, [&](std::size_t block, unsigned) {
+            const std::size_t begin = block * BLOCK;
+            const std::size_t count = std::min(BLOCK, n - begin);
+            for (const auto& position : held_) {
+                accumulate(pnl_.data() + begin, position.first + begin, position.second, count);
+            }
+        });
+        return pnl_;
+    }
+    
+    /**
+     * @brief VaR and expected shortfall at `confidence` (e.g. 0.99)
+     * 
+     * The tail is the k = ceil((1 - confidence) × scenarios) worst
+     * scenarios: VaR is the loss of the k-th worst, expected shortfall the
+     * mean loss of all k. Leaves the P&L buffer partially sorted.
+     */
+    VaRResult compute(const std::vector<double>& exposures, double confidence,
+                      std::size_t window = 0) {
+        if (!(confidence > 0.0 && confidence < 1.0)) {
+            throw std::invalid_argument("VaR confidence must be in (0, 1)");
+        }
+        scenarioPnl(exposures, window);
+        
+        VaRResult result;
+        result.scenarios = pnl_.size();
+        if (pnl_.empty()) return result;
+        
+        const std::size_t k = std::min(pnl_.size(), std::max<std::size_t>(1, static_cast<std::size_t>(
+            std::ceil((1.0 - confidence) * static_cast<double>(pnl_.size()) - 1e-9))));
+        std::nth_element(pnl_.begin(), pnl_.begin() + (k - 1), pnl_.end());
+        double tail = 0.0;
+        for (std::size_t t = 0; t < k; ++t) tail += pnl_[t];
+        
+        result.value_at_risk = -pnl_[k - 1];
+        result.expected_shortfall = -tail / static_cast<double>(k);
+        result.tail_scenarios = k;
+        return result;
+    }
+    
+    /**
+     * @brief Exposures vector from (instrument, signed market value) pairs
+     */
+    std::vector<double> exposures(const std::vector<std::pair<std::string, double>>& positions) const {
+        std::vector<double> out(matrix_.instruments.size(), 0.0);
+        for (const auto& position : positions) {
+            out[matrix_.instrumentIndex(position.first)] += position.second;
+        }
+        return out;
+    }
+};
+
+#endif // HISTORICAL_VAR_HPP
@@ -0,0 +1,240 @@
+#ifndef INDICATOR_CACHE_HPP
+#define INDICATOR_CACHE_HPP
+
+#include <atomic>
+#include <cstdint>
+#include <limits>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <string>
+#include <tuple>
+#include <vector>
+#include "binary_io.hpp"
+#include "candle_columns.hpp"
+#include "fixed_ema.hpp"
+#include "rolling_window.hpp"
+#include "trading_engine.hpp"
+
+/**
+ * @file indicator_cache.hpp
+ * @brief Cross-run cache of full-session indicator series
+ * 
+ * A parameter sweep over GAP_THRESHOLD and stop/target percentages runs
+ * thousands of configurations over the same sessions, yet only touches a
+ * handful of distinct (indicator, period) pairs per instrument. Each series
+ * is computed once, stored as a compact column, and shared read-only by
+ * every sweep worker. Indicator work then drops out of the per-configuration
+ * cost.
+ * 
+ * Thread-safety: lookups take a shared lock; only misses take the exclusive
+ * lock (and compute outside it). Series are immutable once published.
+ */
+
+/**
+ * @brief Cache key: (instrument, session, price fingerprint, indicator, period, source)
+ * 
+ * The fingerprint (CandleColumns::fingerprint) ties a series to the prices
+ * it was computed from, so an edited session file misses instead of
+ * serving the old series, even under the same session id.
+ */
+struct SeriesKey {
+    std::string instrument;
+    std::string session;
+    std::uint64_t fingerprint;
+    IndicatorType type;
+    int period;
+    PriceSource source;
+    
+    bool operator<(const SeriesKey& other) const {
+        return std::tie(instrument, session, fingerprint, type, period, source) <
+               std::tie(other.instrument, other.session, other.fingerprint, other.type,
+                        other.period, other.source);
+    }
+};
+
+using SeriesPtr = std::shared_ptr<const std::vector<double>>;
+
+/**
+ * @brief Compute one full-session indicator series from SoA columns
+ * 
+ * Values match what IndicatorRegistry produces candle by candle. Rolling
+ * extremes cover the `period` candles before each one and are NaN until
+ * that many exist (where the registry reports not ready).
+ */
+inline std::vector<double> computeIndicatorSeries(const CandleColumns& columns,
+                                                  IndicatorType type, int period,
+                                                  PriceSource source) {
+    if (period <= 0) {
+        throw std::invalid_argument("Indicator period must be positive");
+    }
+    
+    const std::vector<double>& input = columns.column(source);
+    std::vector<double> series(input.size());
+    
+    switch (type) {
+        case IndicatorType::EMA:
+            computeEMASeries(period, input.data(), series.data(), input.size());
+            break;
+        case IndicatorType::ROLLING_MIN:
+            computeRollingMinSeries(input.data(), series.data(), input.size(),
+                                    static_cast<std::size_t>(period));
+            break;
+        case IndicatorType::ROLLING_MAX:
+            computeRollingMaxSeries(input.data(), series.data(), input.size(),
+                                    static_cast<std::size_t>(period));
+            break;
+    }
+    
+    if (type != IndicatorType::EMA) {
+        // Lag one candle: series[i] = extreme of input[i - period .. i - 1]
+        const std::size_t lookback = static_cast<std::size_t>(period);
+        for (std::size_t i = series.size(); i-- > 0;) {
+            series[i] = i >= lookback ? series[i - 1] : std::numeric_limits<double>::quiet_NaN();
+        }
+    }
+    return series;
+}
+
+/**
+ * @class IndicatorSeriesCache
+ * @brief Shared, optionally persisted store of indicator columns
+ */
+class IndicatorSeriesCache {
+private:
+    static constexpr char FILE_MAGIC[4] = {'M', 'E', 'I', 'C'};
+    static constexpr std::uint32_t FILE_VERSION = 3;
+    
+    mutable std::shared_mutex mutex_;
+    std::map<SeriesKey, SeriesPtr> series_;
+    
+    mutable std::atomic<std::uint64_t> hits_{0};
+    mutable std::atomic<std::uint64_t> misses_{0};
+    
+public:
+    IndicatorSeriesCache() = default;
+    IndicatorSeriesCache(const IndicatorSeriesCache&) = delete;
+    IndicatorSeriesCache& operator=(const IndicatorSeriesCache&) = delete;
+    
+    /**
+     * @brief Cached series, or nullptr if absent
+     */
+    SeriesPtr find(const SeriesKey& key) const {
+        std::shared_lock<std::shared_mutex> lock(mutex_);
+        auto it = series_.find(key);
+        return it == series_.end() ? nullptr : it->second;
+    }
+    
+    /**
+     * @brief Return the cached series, computing and publishing it on a miss
+     * 
+     * A cached series whose length differs from the session's candle count
+     * is stale (the session data changed) and is recomputed.
+     */
+    SeriesPtr getOrCompute(const MarketData& data, const CandleColumns& columns,
+                           IndicatorType type, int period,
+                           PriceSource source = PriceSource::CLOSE) {
+        SeriesKey key{data.instrument, data.session, columns.fingerprint, type, period, source};
+        
+        SeriesPtr cached = find(key);
+        if (cached && cached->size() == columns.size()) {
+            hits_.fetch_add(1, std::memory_order_relaxed);
+            return cached;
+        }
+        misses_.fetch_add(1, std::memory_order_relaxed);
+        
+        auto computed = std::make_shared<const std::vector<double>>(
+            computeIndicatorSeries(columns, type, period, source));
+        
+        std::unique_lock<std::shared_mutex> lock(mutex_);
+        SeriesPtr& slot = series_[key];
+        // Another worker may have published the same series meanwhile
+        if (!slot || slot->size() != columns.size()) {
+            slot = computed;
+        }
+        return slot;
+    }
+    
+    void insert(const SeriesKey& key, std::vector<double> series) {
+        auto ptr = std::make_shared<const std::vector<double>>(std::move(series));
+        std::unique_lock<std::shared_mutex> lock(mutex_);
+        series_[key] = std::move(ptr);
+    }
+    
+    std::size_t size() const {
+        std::shared_lock<std::shared_mutex> lock(mutex_);
+        return series_.size();
+    }
+    
+    void clear() {
+        std::unique_lock<std::shared_mutex> lock(mutex_);
+        series_.clear();
+    }
+    
+    std::uint64_t getHits() const { return hits_.load(std::memory_order_relaxed); }
+    std::uint64_t getMisses() const { return misses_.load(std::memory_order_relaxed); }
+    
+    /**
+     * @brief Persist every cached series to a single binary file
+     */
+    void saveToFile(const std::string& filename) const {
+        BinaryWriter out;
+        out.writeBytes(FILE_MAGIC, sizeof(FILE_MAGIC));
+        out.write(FILE_VERSION);
+        
+        std::shared_lock<std::shared_mutex> lock(mutex_);
+        out.write(static_cast<std::uint64_t>(series_.size()));
+        for (const auto& entry : series_) {
+            const SeriesKey& key = entry.first;
+            const std::vector<double>& values = *entry.second;
+            out.writeString(key.instrument);
+            out.writeString(key.session);
+            out.write(key.fingerprint);
+            out.write(static_cast<std::int32_t>(key.type));
+            out.write(static_cast<std::int32_t>(key.period));
+            out.write(static_cast<std::int32_t>(key.source));
+            out.write(static_cast<std::uint64_t>(values.size()));
+            out.writeBytes(reinterpret_cast<const char*>(values.data()),
+                           values.size() * sizeof(double));
+        }
+        lock.unlock();
+        
+        writeBinaryFile(filename, out.data());
+    }
+    
+    /**
+     * @brief Merge series from a file written by saveToFile()
+     * @return Number of series loaded
+     */
+    std::size_t loadFromFile(const std::string& filename) {
+        std::string buffer = readBinaryFile(filename);
+        BinaryReader in(buffer);
+        
+        char magic[sizeof(FILE_MAGIC)];
+        in.readBytes(magic, sizeof(magic));
+        if (std::memcmp(magic, FILE_MAGIC, sizeof(magic)) != 0 ||
+            in.read<std::uint32_t>() != FILE_VERSION) {
+            throw std::runtime_error("Not an indicator cache file: " + filename);
+        }
+        
+        std::uint64_t count = in.read<std::uint64_t>();
+        for (std::uint64_t i = 0; i < count; ++i) {
+            SeriesKey key;
+            key.instrument = in.readString();
+            key.session = in.readString();
+            key.fingerprint = in.read<std::uint64_t>();
+            key.type = static_cast<IndicatorType>(in.read<std::int32_t>());
+            key.period = in.read<std::int32_t>();
+            key.source = static_cast<PriceSource>(in.read<std::int32_t>());
+            
+            std::vector<double> values(in.readCount<std::uint64_t>(sizeof(double)));
+            in.readBytes(reinterpret_cast<char*>(values.data()),
+                         values.size() * sizeof(double));
+            insert(key, std::move(values));
+        }
+        return static_cast<std::size_t>(count);
+    }
+};
+
+#endif // INDICATOR_CACHE_HPP
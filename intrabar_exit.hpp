@@ -0,0 +1,270 @@
+#ifndef INTRABAR_EXIT_HPP
+#define INTRABAR_EXIT_HPP
+
+#include <algorithm>
+#include <cstdint>
+#include <functional>
+#include <utility>
+#include <vector>
+#include "backtest_kernel.hpp"
+#include "candle_columns.hpp"
+#include "signal_scan.hpp"
+#include "tick_aggregator.hpp"
+
+/**
+ * @file intrabar_exit.hpp
+ * @brief Stop / target exits resolved inside the bar, with lazy drill-down
+ * 
+ * TradingEngine and runSignalBacktest test SL / TP on the candle close
+ * only, so a bar that spikes through the stop and recovers never exits.
+ * Here SL / TP are trigger prices compared against each bar's high / low:
+ * 
+ *   1. Vector search (findFirstBarOutside) for the first bar whose range
+ *      reaches a trigger; bars in between cost a compare each.
+ *   2. Only for that bar, ask a FineDataLoader for its sub-bars (1-minute
+ *      bars, or ticks as flat bars) and find the first one that reaches a
+ *      trigger the same way.
+ *   3. Resolve that (sub-)bar on its OHLC: an open beyond a trigger fills
+ *      at the open (a gap, or a tick printing through the trigger); a range
+ *      spanning both triggers is assumed to hit the stop first; otherwise
+ *      the touched trigger fills at its price.
+ *      Without fine data the bar itself is resolved this way.
+ * 
+ * Positions are short (the strategy only sells): the stop sits above the
+ * entry, the target below. The market-close bar is still checked for
+ * triggers before it squares off at its close.
+ */
+
+enum class ExitReason { STOP_LOSS, TAKE_PROFIT, MARKET_CLOSE, END_OF_DATA };
+
+struct IntrabarExit {
+    std::size_t bar;        // Bar in which the position closes
+    double price;           // Fill price
+    ExitReason reason;
+    bool from_fine_data;    // Resolved on a sub-bar
+};
+
+/**
+ * @brief Finer-grained bar inside a bar; a tick is a flat bar at its price
+ */
+struct SubBar {
+    std::int64_t timestamp_ms;
+    double open;
+    double high;
+    double low;
+    double close;
+};
+
+/**
+ * @brief Appends the sub-bars of bar `bar`, in time order
+ * 
+ * Leaving `out` empty means no finer data for that bar (bar-level fallback).
+ */
+using FineDataLoader = std::function<void(std::size_t bar, std::vector<SubBar>& out)>;
+
+/**
+ * @brief Trigger prices for a short of `quantity` at `entry_price`
+ * 
+ * P&L reaches -stop_loss at close >= stop_price and +take_profit at
+ * close <= target_price (same amounts as RiskManager::checkExitConditions).
+ */
+struct TriggerPrices {
+    double stop_price;
+    double target_price;
+    
+    static TriggerPrices forShort(double entry_price, int quantity,
+                                  double stop_loss, double take_profit) {
+        return TriggerPrices{entry_price + stop_loss / quantity,
+                             entry_price - take_profit / quantity};
+    }
+};
+
+// ============================================================================
+// EXIT ENGINE
+// ============================================================================
+
+/**
+ * @class IntrabarExitEngine
+ * @brief First exit of a short position over one session's bars
+ */
+class IntrabarExitEngine {
+private:
+    const CandleColumns& bars_;
+    FineDataLoader loader_;
+    std::vector<SubBar> sub_bars_;
+    std::size_t drilldowns_ = 0;
+    std::size_t sub_bars_scanned_ = 0;
+    
+    /**
+     * @brief Fill of a (sub-)bar known to reach a trigger
+     */
+    static IntrabarExit resolve(std::size_t j, double open, double high,
+                                const TriggerPrices& triggers, bool fine) {
+        if (open >= triggers.stop_price) {
+            return IntrabarExit{j, open, ExitReason::STOP_LOSS, fine};
+        }
+        if (open <= triggers.target_price) {
+            return IntrabarExit{j, open, ExitReason::TAKE_PROFIT, fine};
+        }
+        if (high >= triggers.stop_price) {
+            return IntrabarExit{j, triggers.stop_price, ExitReason::STOP_LOSS, fine};
+        }
+        return IntrabarExit{j, triggers.target_price, ExitReason::TAKE_PROFIT, fine};
+    }
+    
+public:
+    /**
+     * @param loader Optional; without one every crossing resolves on the bar
+     */
+    explicit IntrabarExitEngine(const CandleColumns& bars, FineDataLoader loader = nullptr)
+        : bars_(bars), loader_(std::move(loader)) {}
+    
+    /**
+     * @brief Exit of a short entered at the close of bar `entry`
+     * @param market_close_minute Square off at the close of the first bar
+     *        at or after this minute of day
+     */
+    IntrabarExit findExit(std::size_t entry, const TriggerPrices& triggers,
+                          int market_close_minute) {
+        const std::size_t n = bars_.size();
+        const std::size_t cutoff = findFirstAtLeast(bars_.minute.data(), entry + 1, n,
+                                                    market_close_minute);
+        const std::size_t last = std::min(cutoff + 1, n);
+        
+        for (std::size_t j = entry + 1;; ++j) {
+            j = findFirstBarOutside(bars_.high.data(), bars_.low.data(), j, last,
+                                    triggers.target_price, triggers.stop_price);
+            if (j >= last) break;
+            if (loader_) {
+                sub_bars_.clear();
+                loader_(j, sub_bars_);
+            }
+            if (!loader_ || sub_bars_.empty()) {
+                return resolve(j, bars_.open[j], bars_.high[j], triggers, false);
+            }
+            ++drilldowns_;
+            
+            auto hit = std::find_if(sub_bars_.begin(), sub_bars_.end(), [&](const SubBar& sub) {
+                return sub.high >= triggers.stop_price || sub.low <= triggers.target_price;
+            });
+            sub_bars_scanned_ += static_cast<std::size_t>(hit - sub_bars_.begin()) +
+                                 (hit != sub_bars_.end());
+            if (hit != sub_bars_.end()) return resolve(j, hit->open, hit->high, triggers, true);
+            // The bar's range came from data the loader does not have
+        }
+        
+        if (cutoff < n) {
+            return IntrabarExit{cutoff, bars_.close[cutoff], ExitReason::MARKET_CLOSE, false};
+        }
+        return IntrabarExit{n - 1, bars_.close[n - 1], ExitReason::END_OF_DATA, false};
+    }
+    
+    std::size_t drilldowns() const { return drilldowns_; }
+    std::size_t subBarsScanned() const { return sub_bars_scanned_; }
+};
+
+// ============================================================================
+// FINE DATA LOADERS
+// ============================================================================
+
+/**
+ * @brief Ticks of a time-sorted archive that fall inside each bar
+ * 
+ * Bar j covers [minute[j], minute[j] + interval) in exchange time; a lookup
+ * is a binary search into the archive.
+ */
+inline FineDataLoader tickRangeLoader(const std::vector<Tick>& ticks, const CandleColumns& bars,
+                                      int interval_minutes) {
+    const std::int64_t interval_ms = static_cast<std::int64_t>(interval_minutes) * MS_PER_MINUTE;
+    return [&ticks, &bars, interval_ms](std::size_t bar, std::vector<SubBar>& out) {
+        const std::int64_t start = static_cast<std::int64_t>(bars.minute[bar]) * MS_PER_MINUTE;
+        auto first = std::lower_bound(ticks.begin(), ticks.end(), start,
+                                      [](const Tick& tick, std::int64_t ts) {
+                                          return tick.timestamp_ms < ts;
+                                      });
+        for (auto it = first; it != ticks.end() && it->timestamp_ms < start + interval_ms; ++it) {
+            out.push_back(SubBar{it->timestamp_ms, it->price, it->price, it->price, it->price});
+        }
+    };
+}
+
+/**
+ * @brief Time-sorted 1-minute bars that fall inside each bar
+ */
+inline FineDataLoader minuteBarLoader(const CandleColumns& minute_bars, const CandleColumns& bars,
+                                      int interval_minutes) {
+    return [&minute_bars, &bars, interval_minutes](std::size_t bar, std::vector<SubBar>& out) {
+        const int start = bars.minute[bar];
+        auto first = std::lower_bound(minute_bars.minute.begin(), minute_bars.minute.end(), start);
+        for (std::size_t k = static_cast<std::size_t>(first - minute_bars.minute.begin());
+             k < minute_bars.size() && minute_bars.minute[k] < start + interval_minutes; ++k) {
+            out.push_back(SubBar{static_cast<std::int64_t>(minute_bars.minute[k]) * MS_PER_MINUTE,
+                                 minute_bars.open[k], minute_bars.high[k],
+                                 minute_bars.low[k], minute_bars.close[k]});
+        }
+    };
+}
+
+// ============================================================================
+// SESSION BACKTEST
+// ============================================================================
+
+/**
+ * @brief runSignalBacktest with intrabar SL / TP exits
+ * @param exits Exit engine over `columns` (owns the fine-data loader)
+ * 
+ * Entry rules, sizing and trade limits are those of runSignalBacktest; only
+ * the exit candle and fill price differ. A signal on the exit bar may enter
+ * again at that bar's close.
+ */
+inline RunSummary runIntrabarBacktest(const CandleColumns& columns,
+                                      const std::vector<std::uint32_t>& signals,
+                                      double capital, const BacktestConfig& config,
+                                      IntrabarExitEngine& exits,
+                                      std::vector<double>* trade_pnls = nullptr) {
+    RunSummary summary;
+    summary.initial_capital = capital;
+    summary.final_capital = capital;
+    if (columns.empty() || signals.empty()) return summary;
+    
+    const double* close = columns.close.data();
+    const double stop_loss = capital * config.risk.stop_loss_pct;
+    const double take_profit = capital * config.risk.take_profit_pct;
+    
+    double current_capital = capital;
+    double peak_capital = capital;
+    int trades = 0;
+    
+    std::size_t next_signal = 0;
+    while (next_signal < signals.size() && trades < config.risk.max_daily_trades) {
+        const std::size_t entry = signals[next_signal++];
+        const double entry_price = close[entry];
+        const int quantity = entry_price > 0
+            ? static_cast<int>(current_capital / entry_price) : 0;
+        if (quantity <= 0) continue;
+        ++trades;
+        
+        IntrabarExit exit = exits.findExit(
+            entry, TriggerPrices::forShort(entry_price, quantity, stop_loss, take_profit),
+            config.risk.market_close_minute);
+        
+        const double pnl = (entry_price - exit.price) * quantity;
+        current_capital += pnl;
+        summary.wins += pnl > 0;
+        summary.losses += pnl < 0;
+        peak_capital = std::max(peak_capital, current_capital);
+        summary.max_drawdown = std::max(summary.max_drawdown, peak_capital - current_capital);
+        if (trade_pnls) trade_pnls->push_back(pnl);
+        
+        if (exit.reason == ExitReason::MARKET_CLOSE || exit.reason == ExitReason::END_OF_DATA) {
+            break;
+        }
+        while (next_signal < signals.size() && signals[next_signal] < exit.bar) ++next_signal;
+    }
+    
+    summary.trades = trades;
+    summary.final_capital = current_capital;
+    return summary;
+}
+
+#endif // INTRABAR_EXIT_HPP
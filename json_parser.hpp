@@ -140,6 +140,8 @@ private:
                 candle.low = parseNumber();
             } else if (key == "close") {
                 candle.close = parseNumber();
+            } else if (key == "volume") {
+                candle.volume = parseNumber();
             } else {
                 skipValue();
             }
@@ -170,6 +172,8 @@ public:
             
             if (key == "instrument") {
                 data.instrument = parseString();
+            } else if (key == "session" || key == "date") {
+                data.session = parseString();
             } else if (key == "previous_day_close") {
                 data.previous_day_close = parseNumber();
             } else if (key == "capital") {
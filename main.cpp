@@ -1,8 +1,15 @@
 #include <iostream>
 #include <thread>
 #include <chrono>
+#include <fstream>
 #include "json_parser.hpp"
+#include "optimizer.hpp"
+#include "parameter_sweep.hpp"
+#include "rule_dsl.hpp"
+#include "signal_export.hpp"
+#include "tick_aggregator.hpp"
 #include "trading_engine.hpp"
+#include "walk_forward.hpp"
 
 /**
  * @file main.cpp
@@ -22,14 +29,373 @@
  * In production: This would be replaced by market data adapter
  * consuming from exchange feed handler (e.g., 0MQ, gRPC streaming).
  */
-void simulateLiveDataFeed(const MarketData& data) {
+void simulateLiveDataFeed(const MarketData& data, const std::string& setup_rule = "",
+                          const std::string& trigger_rule = "low < setup_low") {
     const int CANDLE_DELAY_MS = 500;  // 500ms between candles (compressed time)
     
     std::cout << "\n[SIMULATION] Processing candles with " 
               << CANDLE_DELAY_MS << "ms delay to simulate live feed...\n" << std::endl;
     
-    TradingEngine engine(data);
-    engine.run();
+    if (setup_rule.empty()) {
+        TradingEngine engine(data);
+        engine.run();
+    } else {
+        // Entry conditions compiled from text (rule_dsl.hpp)
+        TradingEngine<RuleStrategy> engine(data, RuleStrategy(setup_rule, trigger_rule));
+        engine.run();
+    }
+}
+
+/**
+ * @brief Build session candles from a tick archive
+ * 
+ * Usage: --ticks <file> <instrument> <prev_close> <capital> [interval_min] [tolerance_ms]
+ * Files ending in .csv are parsed as text, anything else as binary archive.
+ * tolerance_ms (default 0) is how late an out-of-order tick may arrive
+ * and still count; later ticks are dropped and reported.
+ */
+MarketData loadFromTickArchive(int argc, char* argv[]) {
+    if (argc < 6) {
+        throw std::runtime_error(
+            "Usage: --ticks <file> <instrument> <prev_close> <capital> [interval_min] [tolerance_ms]");
+    }
+    
+    std::string tick_file = argv[2];
+    int interval_minutes = argc > 6 ? std::stoi(argv[6]) : 5;
+    std::int64_t tolerance_ms = argc > 7 ? std::stoll(argv[7]) : 0;
+    
+    std::cout << "Loading ticks from: " << tick_file << std::endl;
+    
+    bool is_csv = tick_file.size() >= 4 &&
+                  tick_file.compare(tick_file.size() - 4, 4, ".csv") == 0;
+    std::vector<Tick> ticks = is_csv ? loadTicksCSV(tick_file) : loadTicksBinary(tick_file);
+    
+    std::cout << "Aggregating " << ticks.size() << " ticks into "
+              << interval_minutes << "-minute candles" << std::endl;
+    
+    std::uint64_t dropped = 0;
+    MarketData data = buildMarketDataFromTicks(ticks, argv[3], std::stod(argv[4]),
+                                               std::stod(argv[5]), interval_minutes,
+                                               tolerance_ms, &dropped);
+    std::cout << "Dropped " << dropped << " late ticks (tolerance "
+              << tolerance_ms << " ms)" << std::endl;
+    return data;
+}
+
+/**
+ * @brief Options shared by --sweep, --walk-forward, --optimize and --signals
+ */
+enum class BatchMode { SWEEP, WALK_FORWARD, OPTIMIZE, SIGNALS };
+
+struct SweepOptions {
+    SweepSpec spec;
+    WalkForwardSpec walk_forward;
+    OptimizerSpec optimizer;
+    MonteCarloSpec monte_carlo;
+    bool bootstrap = false;
+    int ema_fast_period = 3;
+    unsigned threads = 0;
+    std::string out_file;
+    std::string cache_file;
+    std::vector<std::string> files;
+};
+
+SweepOptions parseSweepOptions(int argc, char* argv[], BatchMode mode) {
+    SweepOptions options;
+    options.out_file = mode == BatchMode::WALK_FORWARD ? "walk_forward.csv"
+                     : mode == BatchMode::OPTIMIZE ? "optimize_results.csv"
+                     : mode == BatchMode::SIGNALS ? "signals.bin"
+                     : "sweep_results.csv";
+    const bool sweep = mode == BatchMode::SWEEP;
+    const bool walk_forward = mode == BatchMode::WALK_FORWARD;
+    const bool optimize = mode == BatchMode::OPTIMIZE;
+    const bool signals = mode == BatchMode::SIGNALS;
+    
+    for (int i = 2; i < argc; ++i) {
+        std::string arg = argv[i];
+        bool has_value = i + 1 < argc;
+        if (arg == "--gap" && has_value) {
+            options.spec.gap_threshold = SweepRange::parse(argv[++i]);
+        } else if (arg == "--ema-slow" && has_value) {
+            options.spec.ema_slow_period = SweepRange::parse(argv[++i]);
+        } else if (!signals && arg == "--stop-loss" && has_value) {
+            options.spec.stop_loss_pct = SweepRange::parse(argv[++i]);
+        } else if (!signals && arg == "--take-profit" && has_value) {
+            options.spec.take_profit_pct = SweepRange::parse(argv[++i]);
+        } else if (!signals && arg == "--max-trades" && has_value) {
+            options.spec.max_daily_trades = SweepRange::parse(argv[++i]);
+        } else if (!signals && arg == "--close-minute" && has_value) {
+            options.spec.market_close_minute = SweepRange::parse(argv[++i]);
+        } else if (signals && arg == "--ema-fast" && has_value) {
+            options.ema_fast_period = std::stoi(argv[++i]);
+        } else if (arg == "--threads" && has_value) {
+            options.threads = static_cast<unsigned>(std::stoul(argv[++i]));
+        } else if (arg == "--out" && has_value) {
+            options.out_file = argv[++i];
+        } else if (arg == "--cache" && has_value) {
+            options.cache_file = argv[++i];
+        } else if (sweep && arg == "--monte-carlo" && has_value) {
+            options.monte_carlo.paths = std::stoul(argv[++i]);
+            options.bootstrap = options.monte_carlo.paths > 0;
+        } else if (sweep && arg == "--mc-block" && has_value) {
+            options.monte_carlo.block_length = std::stoul(argv[++i]);
+        } else if (walk_forward && arg == "--train" && has_value) {
+            options.walk_forward.train_sessions = std::stoul(argv[++i]);
+        } else if (walk_forward && arg == "--test" && has_value) {
+            options.walk_forward.test_sessions = std::stoul(argv[++i]);
+        } else if (walk_forward && arg == "--step" && has_value) {
+            options.walk_forward.step_sessions = std::stoul(argv[++i]);
+        } else if (optimize && arg == "--population" && has_value) {
+            options.optimizer.population = std::stoul(argv[++i]);
+        } else if (optimize && arg == "--min-sessions" && has_value) {
+            options.optimizer.min_sessions = std::stoul(argv[++i]);
+        } else if (optimize && arg == "--eta" && has_value) {
+            options.optimizer.eta = std::stoul(argv[++i]);
+        } else if (optimize && arg == "--seed" && has_value) {
+            options.optimizer.seed = std::stoull(argv[++i]);
+        } else if (arg.compare(0, 2, "--") == 0) {
+            throw std::runtime_error("Unknown sweep option: " + arg);
+        } else {
+            options.files.push_back(arg);
+        }
+    }
+    
+    if (options.files.empty()) {
+        throw std::runtime_error(std::string(argv[1]) + " needs at least one session file");
+    }
+    return options;
+}
+
+/**
+ * @brief Parameter sweep over one or more session files
+ * 
+ * Usage: --sweep [options] <session.json>...
+ *   --gap R, --ema-slow R, --stop-loss R, --take-profit R, --max-trades R,
+ *   --close-minute R (square-off minute of day, e.g. 840:915:15)
+ *       where R is a value or start:stop:step
+ *   --threads N     Worker threads (default: all cores)
+ *   --out FILE      Results table CSV (default: sweep_results.csv)
+ *   --cache FILE    Indicator series cache, loaded if present and saved after
+ *   --monte-carlo N Bootstrap N trade sequences per configuration
+ *   --mc-block L    Block length for the block bootstrap (default: 1)
+ */
+int runSweepMode(int argc, char* argv[]) {
+    SweepOptions options = parseSweepOptions(argc, argv, BatchMode::SWEEP);
+    
+    MarketUniverse universe = MarketUniverse::loadFromFiles(options.files);
+    IndicatorSeriesCache cache;
+    if (!options.cache_file.empty() && std::ifstream(options.cache_file).good()) {
+        std::cout << "Loaded " << cache.loadFromFile(options.cache_file)
+                  << " cached indicator series" << std::endl;
+    }
+    
+    std::vector<BacktestConfig> configs = options.spec.expand();
+    std::cout << "Sweeping " << configs.size() << " configurations over "
+              << universe.size() << " sessions..." << std::endl;
+    
+    double min_gap = options.spec.gap_threshold.values().front();
+    std::cout << "Pre-screen: " << universe.countGapCandidates(min_gap) << " of "
+              << universe.size() << " sessions can gap up at "
+              << min_gap * 100.0 << "%" << std::endl;
+    
+    auto start = std::chrono::steady_clock::now();
+    ParameterSweep sweep(universe, cache, options.threads);
+    std::vector<SweepResult> results = sweep.run(
+        configs, options.bootstrap ? &options.monte_carlo : nullptr);
+    double elapsed = std::chrono::duration<double>(
+        std::chrono::steady_clock::now() - start).count();
+    
+    sortSweepResults(results);
+    writeSweepResultsCSV(options.out_file, results);
+    if (!options.cache_file.empty()) cache.saveToFile(options.cache_file);
+    
+    std::cout << std::fixed << std::setprecision(4);
+    std::cout << "Completed " << configs.size() * universe.size() << " runs in "
+              << elapsed << "s" << std::endl;
+    std::cout << "\nTop configurations:\n";
+    std::cout << "   gap   ema    SL     TP  max |   total P&L  trades    win%";
+    std::cout << (options.bootstrap ? " |  p5 final cap   p95 DD  ruin%\n" : "\n");
+    for (std::size_t i = 0; i < std::min<std::size_t>(results.size(), 10); ++i) {
+        const auto& r = results[i];
+        std::cout << std::setprecision(3) << std::setw(6) << r.config.strategy.gap_threshold
+                  << std::setw(6) << r.config.strategy.ema_slow_period
+                  << std::setw(6) << r.config.risk.stop_loss_pct
+                  << std::setw(7) << r.config.risk.take_profit_pct
+                  << std::setw(5) << r.config.risk.max_daily_trades << " | "
+                  << std::setprecision(2) << std::setw(11) << r.stats.total_pnl
+                  << std::setw(8) << r.stats.trades
+                  << std::setw(8) << r.stats.winRate() * 100.0;
+        if (options.bootstrap) {
+            std::cout << " |" << std::setw(14) << r.monte_carlo.final_capital_p5
+                      << std::setw(9) << r.monte_carlo.max_drawdown_p95
+                      << std::setw(7) << r.monte_carlo.ruin_probability * 100.0;
+        }
+        std::cout << std::endl;
+    }
+    std::cout << "\nResults written to: " << options.out_file << std::endl;
+    return 0;
+}
+
+/**
+ * @brief Walk-forward optimisation over chronologically ordered session files
+ * 
+ * Usage: --walk-forward --train N --test N [--step N] [sweep options] <session.json>...
+ *   --train N       In-sample sessions per window (default: 20)
+ *   --test N        Out-of-sample sessions per window (default: 5)
+ *   --step N        Window advance (default: --test)
+ *   --out FILE      Per-window table CSV (default: walk_forward.csv)
+ */
+int runWalkForwardMode(int argc, char* argv[]) {
+    SweepOptions options = parseSweepOptions(argc, argv, BatchMode::WALK_FORWARD);
+    
+    MarketUniverse universe = MarketUniverse::loadFromFiles(options.files);
+    IndicatorSeriesCache cache;
+    if (!options.cache_file.empty() && std::ifstream(options.cache_file).good()) {
+        std::cout << "Loaded " << cache.loadFromFile(options.cache_file)
+                  << " cached indicator series" << std::endl;
+    }
+    
+    std::vector<BacktestConfig> configs = options.spec.expand();
+    WalkForwardOptimizer optimizer(universe, cache, options.walk_forward, options.threads);
+    std::cout << "Walk-forward: " << configs.size() << " configurations, "
+              << optimizer.layout().size() << " windows (train "
+              << options.walk_forward.train_sessions << ", test "
+              << options.walk_forward.test_sessions << ", step "
+              << options.walk_forward.step() << ") over "
+              << universe.size() << " sessions..." << std::endl;
+    
+    auto start = std::chrono::steady_clock::now();
+    WalkForwardReport report = optimizer.run(configs);
+    double elapsed = std::chrono::duration<double>(
+        std::chrono::steady_clock::now() - start).count();
+    
+    writeWalkForwardCSV(options.out_file, report);
+    if (!options.cache_file.empty()) cache.saveToFile(options.cache_file);
+    
+    std::cout << std::fixed << std::setprecision(2);
+    std::cout << "Completed in " << elapsed << "s\n\n";
+    std::cout << "  window     train      test |   gap  ema    SL     TP  max close |"
+                 "     IS P&L    OOS P&L\n";
+    for (std::size_t w = 0; w < report.windows.size(); ++w) {
+        const auto& r = report.windows[w];
+        std::cout << std::setw(8) << w
+                  << std::setw(5) << r.train_begin << '-' << std::setw(4) << r.train_end
+                  << std::setw(5) << r.test_begin << '-' << std::setw(4) << r.test_end << " |"
+                  << std::setprecision(3) << std::setw(6) << r.best.strategy.gap_threshold
+                  << std::setw(5) << r.best.strategy.ema_slow_period
+                  << std::setw(6) << r.best.risk.stop_loss_pct
+                  << std::setw(7) << r.best.risk.take_profit_pct
+                  << std::setw(5) << r.best.risk.max_daily_trades
+                  << std::setw(6) << formatMinuteOfDay(r.best.risk.market_close_minute) << " |"
+                  << std::setprecision(2) << std::setw(11) << r.in_sample.total_pnl
+                  << std::setw(11) << r.out_of_sample.total_pnl << std::endl;
+    }
+    std::cout << "\nOut-of-sample: " << report.out_of_sample.sessions << " sessions, P&L "
+              << report.out_of_sample.total_pnl << ", max drawdown "
+              << report.out_of_sample.equity_drawdown << ", efficiency "
+              << report.efficiency() << std::endl;
+    std::cout << "Results written to: " << options.out_file << std::endl;
+    return 0;
+}
+
+/**
+ * @brief Budgeted search over the sweep grid (successive halving + hill climbing)
+ * 
+ * Usage: --optimize [sweep ranges] [options] <session.json>...
+ *   --population N   Initial candidates (default: 1% of the grid)
+ *   --min-sessions N First-rung session budget (default: 10% of sessions)
+ *   --eta N          Keep 1/N per rung (default: 3)
+ *   --seed N         Sampling seed
+ *   --out FILE       Finalists CSV (default: optimize_results.csv)
+ */
+int runOptimizeMode(int argc, char* argv[]) {
+    SweepOptions options = parseSweepOptions(argc, argv, BatchMode::OPTIMIZE);
+    
+    MarketUniverse universe = MarketUniverse::loadFromFiles(options.files);
+    IndicatorSeriesCache cache;
+    if (!options.cache_file.empty() && std::ifstream(options.cache_file).good()) {
+        std::cout << "Loaded " << cache.loadFromFile(options.cache_file)
+                  << " cached indicator series" << std::endl;
+    }
+    
+    auto start = std::chrono::steady_clock::now();
+    SuccessiveHalvingOptimizer optimizer(universe, cache, options.optimizer, options.threads);
+    OptimizerResult result = optimizer.run(options.spec);
+    double elapsed = std::chrono::duration<double>(
+        std::chrono::steady_clock::now() - start).count();
+    
+    writeSweepResultsCSV(options.out_file, result.finalists);
+    if (!options.cache_file.empty()) cache.saveToFile(options.cache_file);
+    
+    std::cout << std::fixed << std::setprecision(2);
+    std::cout << "Searched " << result.candidates << " of " << result.grid_size
+              << " configurations in " << result.rungs << " rungs: "
+              << result.session_runs << " session runs ("
+              << result.evaluationFraction() * 100.0 << "% of the full grid) in "
+              << elapsed << "s" << std::endl;
+    std::cout << "\nFinalists:\n";
+    std::cout << "   gap   ema    SL     TP  max close |   total P&L  trades    win%\n";
+    for (std::size_t i = 0; i < std::min<std::size_t>(result.finalists.size(), 10); ++i) {
+        const auto& r = result.finalists[i];
+        std::cout << std::setprecision(3) << std::setw(6) << r.config.strategy.gap_threshold
+                  << std::setw(6) << r.config.strategy.ema_slow_period
+                  << std::setw(6) << r.config.risk.stop_loss_pct
+                  << std::setw(7) << r.config.risk.take_profit_pct
+                  << std::setw(5) << r.config.risk.max_daily_trades
+                  << std::setw(6) << formatMinuteOfDay(r.config.risk.market_close_minute) << " | "
+                  << std::setprecision(2) << std::setw(11) << r.stats.total_pnl
+                  << std::setw(8) << r.stats.trades
+                  << std::setw(8) << r.stats.winRate() * 100.0 << std::endl;
+    }
+    std::cout << "\nResults written to: " << options.out_file << std::endl;
+    return 0;
+}
+
+/**
+ * @brief Signal-only research run: signal candles and EMAs, no execution
+ * 
+ * Usage: --signals [--gap R] [--ema-slow R] [--ema-fast N] [options] <session.json>...
+ *   Every (gap, ema-slow) combination is scanned as one strategy
+ *   --ema-fast N    Fast EMA period recorded with each signal (default: 3)
+ *   --threads N     Worker threads (default: all cores)
+ *   --out FILE      Columnar signal table (default: signals.bin)
+ *   --cache FILE    Indicator series cache, loaded if present and saved after
+ */
+int runSignalsMode(int argc, char* argv[]) {
+    SweepOptions options = parseSweepOptions(argc, argv, BatchMode::SIGNALS);
+    
+    MarketUniverse universe = MarketUniverse::loadFromFiles(options.files);
+    IndicatorSeriesCache cache;
+    if (!options.cache_file.empty() && std::ifstream(options.cache_file).good()) {
+        std::cout << "Loaded " << cache.loadFromFile(options.cache_file)
+                  << " cached indicator series" << std::endl;
+    }
+    
+    std::vector<StrategyParams> strategies;
+    for (double gap : options.spec.gap_threshold.values()) {
+        for (double slow : options.spec.ema_slow_period.values()) {
+            StrategyParams params;
+            params.gap_threshold = gap;
+            params.ema_fast_period = options.ema_fast_period;
+            params.ema_slow_period = static_cast<int>(std::lround(slow));
+            strategies.push_back(params);
+        }
+    }
+    
+    auto start = std::chrono::steady_clock::now();
+    SignalExporter exporter(universe, cache, options.threads);
+    SignalTable table = exporter.run(strategies);
+    double elapsed = std::chrono::duration<double>(
+        std::chrono::steady_clock::now() - start).count();
+    
+    writeSignalTable(options.out_file, table);
+    if (!options.cache_file.empty()) cache.saveToFile(options.cache_file);
+    
+    std::cout << std::fixed << std::setprecision(4);
+    std::cout << "Scanned " << strategies.size() << " strategies over " << universe.size()
+              << " sessions in " << elapsed << "s: " << table.size() << " signals" << std::endl;
+    std::cout << "Signals written to: " << options.out_file << std::endl;
+    return 0;
 }
 
 /**
@@ -43,10 +409,43 @@ int main(int argc, char* argv[]) {
             input_file = argv[1];
         }
         
-        std::cout << "Loading market data from: " << input_file << std::endl;
+        if (input_file == "--sweep") {
+            return runSweepMode(argc, argv);
+        }
+        if (input_file == "--walk-forward") {
+            return runWalkForwardMode(argc, argv);
+        }
+        if (input_file == "--optimize") {
+            return runOptimizeMode(argc, argv);
+        }
+        if (input_file == "--signals") {
+            return runSignalsMode(argc, argv);
+        }
         
-        // Load market data
-        MarketData market_data = SimpleJSONParser::loadFromFile(input_file);
+        MarketData market_data;
+        std::string setup_rule;
+        std::string trigger_rule = "low < setup_low";
+        if (input_file == "--ticks") {
+            market_data = loadFromTickArchive(argc, argv);
+        } else {
+            // Optional: --rule "<setup>" [--trigger "<trigger>"]
+            for (int i = 2; i < argc; ++i) {
+                std::string arg = argv[i];
+                bool has_value = i + 1 < argc;
+                if (arg == "--rule" && has_value) {
+                    setup_rule = argv[++i];
+                } else if (arg == "--trigger" && has_value) {
+                    trigger_rule = argv[++i];
+                } else {
+                    throw std::runtime_error("Unknown option: " + arg);
+                }
+            }
+            
+            std::cout << "Loading market data from: " << input_file << std::endl;
+            
+            // Load market data
+            market_data = SimpleJSONParser::loadFromFile(input_file);
+        }
         
         // Validate data
         if (market_data.candles.empty()) {
@@ -63,7 +462,7 @@ int main(int argc, char* argv[]) {
                   << " candles for " << market_data.instrument << std::endl;
         
         // Run trading simulation
-        simulateLiveDataFeed(market_data);
+        simulateLiveDataFeed(market_data, setup_rule, trigger_rule);
         
         std::cout << "\n[SIMULATION COMPLETE]" << std::endl;
         
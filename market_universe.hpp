@@ -0,0 +1,78 @@
+#ifndef MARKET_UNIVERSE_HPP
+#define MARKET_UNIVERSE_HPP
+
+#include <algorithm>
+#include <string>
+#include <vector>
+#include "candle_columns.hpp"
+#include "json_parser.hpp"
+#include "session_index.hpp"
+#include "trading_engine.hpp"
+
+/**
+ * @file market_universe.hpp
+ * @brief Multi-session dataset for batch runs (sweeps, scans, walk-forward)
+ * 
+ * Each session keeps its MarketData (for the engine and cache keys), a
+ * CandleColumns view (for batch kernels) and a SessionIndex pre-screen
+ * summary, all built once at load time.
+ * Sessions keep insertion order; callers add them chronologically when
+ * order matters (walk-forward, cross-session drawdown).
+ */
+
+struct MarketSession {
+    MarketData data;
+    CandleColumns columns;
+    SessionIndex index;
+};
+
+/**
+ * @class MarketUniverse
+ * @brief Ordered collection of instrument sessions
+ */
+class MarketUniverse {
+private:
+    std::vector<MarketSession> sessions_;
+    
+public:
+    void add(MarketData data) {
+        CandleColumns columns = CandleColumns::fromCandles(data.candles);
+        SessionIndex index = buildSessionIndex(columns, data.previous_day_close);
+        sessions_.push_back(MarketSession{std::move(data), std::move(columns), index});
+    }
+    
+    /**
+     * @brief Load one JSON session file per path, in the given order
+     * 
+     * A file without a session id gets its path as the id, so cache keys
+     * stay distinct across files for the same instrument.
+     */
+    static MarketUniverse loadFromFiles(const std::vector<std::string>& files) {
+        MarketUniverse universe;
+        for (const auto& file : files) {
+            MarketData data = SimpleJSONParser::loadFromFile(file);
+            if (data.session.empty()) data.session = file;
+            universe.add(std::move(data));
+        }
+        return universe;
+    }
+    
+    /**
+     * @brief Sessions that can produce a gap-up candle at this threshold
+     */
+    std::size_t countGapCandidates(double gap_threshold) const {
+        return static_cast<std::size_t>(std::count_if(
+            sessions_.begin(), sessions_.end(),
+            [gap_threshold](const MarketSession& s) { return s.index.canGapUp(gap_threshold); }));
+    }
+    
+    std::size_t size() const { return sessions_.size(); }
+    bool empty() const { return sessions_.empty(); }
+    
+    const MarketSession& operator[](std::size_t i) const { return sessions_[i]; }
+    
+    std::vector<MarketSession>::const_iterator begin() const { return sessions_.begin(); }
+    std::vector<MarketSession>::const_iterator end() const { return sessions_.end(); }
+};
+
+#endif // MARKET_UNIVERSE_HPP
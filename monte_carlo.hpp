@@ -0,0 +1,242 @@
+#ifndef MONTE_CARLO_HPP
+#define MONTE_CARLO_HPP
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <stdexcept>
+#include <vector>
+#include "parallel.hpp"
+#include "trading_engine.hpp"
+
+/**
+ * @file monte_carlo.hpp
+ * @brief Bootstrap resampling of realised trade P&L sequences
+ * 
+ * A single backtest yields one equity path; its final capital and drawdown
+ * say little about what the same edge could have produced in a different
+ * order. Resampling the realised trade P&Ls (with replacement, optionally
+ * in circular blocks to keep short-range dependence) gives distributions of
+ * final capital, maximum drawdown and probability of ruin.
+ * 
+ * RANDOMNESS:
+ * Draws are counter-based: draw = hash(path key, step), with the path key
+ * derived from (seed, path index). No generator state is carried between
+ * paths, so any split of paths across threads produces identical results.
+ * 
+ * INNER LOOP:
+ * Paths are simulated LANES at a time in structure-of-arrays form; every
+ * per-step operation (hash, index scaling, equity/peak/drawdown update) is
+ * a fixed-length loop over lanes that the compiler vectorises. Only the
+ * P&L load is a gather.
+ */
+
+/**
+ * @brief Realised P&L of each closed trade in an engine trade log
+ */
+inline std::vector<double> realizedTradePnls(const std::vector<Trade>& trade_log) {
+    std::vector<double> pnls;
+    for (const auto& trade : trade_log) {
+        if (trade.type == Trade::Type::EXIT) pnls.push_back(trade.pnl);
+    }
+    return pnls;
+}
+
+struct MonteCarloSpec {
+    std::size_t paths = 10000;
+    std::size_t block_length = 1;      // 1 = plain bootstrap, >1 = circular block bootstrap
+    std::size_t trades_per_path = 0;   // 0 = as many as were realised
+    double ruin_fraction = 0.5;        // Ruined once capital <= initial * ruin_fraction
+    std::uint64_t seed = 0x5EED;
+};
+
+/**
+ * @brief Distribution summary (percentiles by nearest rank)
+ */
+struct MonteCarloSummary {
+    std::size_t paths = 0;
+    std::size_t trades_per_path = 0;
+    double initial_capital = 0.0;
+    double mean_final_capital = 0.0;
+    double final_capital_p5 = 0.0;
+    double final_capital_p50 = 0.0;
+    double final_capital_p95 = 0.0;
+    double max_drawdown_p50 = 0.0;
+    double max_drawdown_p95 = 0.0;
+    double ruin_probability = 0.0;
+};
+
+/**
+ * @brief Per-path outcomes, indexed by path
+ */
+struct MonteCarloPaths {
+    std::vector<double> final_capital;
+    std::vector<double> max_drawdown;
+    std::vector<std::uint8_t> ruined;
+};
+
+namespace monte_carlo_detail {
+
+// murmur3 finaliser: bijective 32-bit avalanche, vectorises to pmulld
+inline std::uint32_t mix32(std::uint32_t x) {
+    x ^= x >> 16;
+    x *= 0x85EBCA6Bu;
+    x ^= x >> 13;
+    x *= 0xC2B2AE35u;
+    x ^= x >> 16;
+    return x;
+}
+
+inline std::uint32_t pathKey(std::uint64_t seed, std::size_t path) {
+    std::uint32_t seed_key = mix32(static_cast<std::uint32_t>(seed) ^
+                                   mix32(static_cast<std::uint32_t>(seed >> 32)));
+    return mix32(static_cast<std::uint32_t>(path) * 0x9E3779B9u + seed_key);
+}
+
+}  // namespace monte_carlo_detail
+
+/**
+ * @class MonteCarloBootstrap
+ * @brief Parallel bootstrap / block-bootstrap over a trade P&L sample
+ */
+class MonteCarloBootstrap {
+private:
+    static constexpr std::size_t LANES = 8;
+    static constexpr std::size_t PATHS_PER_JOB = 64 * LANES;
+    
+    MonteCarloSpec spec_;
+    unsigned threads_;
+    
+    /**
+     * @brief Simulate paths [begin, end) into the output arrays
+     */
+    void simulate(const std::vector<double>& pnls, double initial_capital,
+                  std::size_t begin, std::size_t end, MonteCarloPaths& out) const {
+        using monte_carlo_detail::mix32;
+        
+        const std::uint32_t n = static_cast<std::uint32_t>(pnls.size());
+        const std::size_t length = spec_.trades_per_path ? spec_.trades_per_path : pnls.size();
+        // Block offsets stay below the sample size, so one wrap suffices
+        const std::size_t block = std::min(std::max<std::size_t>(spec_.block_length, 1),
+                                           pnls.size());
+        const double* sample = pnls.data();
+        
+        for (std::size_t p0 = begin; p0 < end; p0 += LANES) {
+            std::uint32_t key[LANES];
+            std::uint32_t start[LANES] = {};
+            double equity[LANES];
+            double peak[LANES];
+            double drawdown[LANES];
+            double trough[LANES];
+            for (std::size_t j = 0; j < LANES; ++j) {
+                key[j] = monte_carlo_detail::pathKey(spec_.seed, p0 + j);
+                equity[j] = initial_capital;
+                peak[j] = initial_capital;
+                drawdown[j] = 0.0;
+                trough[j] = initial_capital;
+            }
+            
+            for (std::size_t step = 0; step < length; ++step) {
+                const std::uint32_t offset = static_cast<std::uint32_t>(step % block);
+                if (offset == 0) {
+                    const std::uint32_t counter = mix32(static_cast<std::uint32_t>(step));
+                    for (std::size_t j = 0; j < LANES; ++j) {
+                        std::uint32_t h = mix32(key[j] ^ counter);
+                        start[j] = static_cast<std::uint32_t>(
+                            (static_cast<std::uint64_t>(h) * n) >> 32);
+                    }
+                }
+                for (std::size_t j = 0; j < LANES; ++j) {
+                    std::uint32_t idx = start[j] + offset;
+                    idx -= idx >= n ? n : 0;  // Circular block
+                    equity[j] += sample[idx];
+                    peak[j] = std::max(peak[j], equity[j]);
+                    drawdown[j] = std::max(drawdown[j], peak[j] - equity[j]);
+                    trough[j] = std::min(trough[j], equity[j]);
+                }
+            }
+            
+            const double ruin_level = initial_capital * spec_.ruin_fraction;
+            const std::size_t lanes = std::min(LANES, end - p0);
+            for (std::size_t j = 0; j < lanes; ++j) {
+                out.final_capital[p0 + j] = equity[j];
+                out.max_drawdown[p0 + j] = drawdown[j];
+                out.ruined[p0 + j] = trough[j] <= ruin_level;
+            }
+        }
+    }
+    
+    /**
+     * @brief Nearest rank: the ceil(q * n)-th smallest value (1-based)
+     */
+    static double percentile(const std::vector<double>& sorted, double q) {
+        const double rank = std::ceil(q * static_cast<double>(sorted.size()) - 1e-9);
+        const std::size_t index = rank > 1.0 ? static_cast<std::size_t>(rank) - 1 : 0;
+        return sorted[std::min(index, sorted.size() - 1)];
+    }
+    
+public:
+    explicit MonteCarloBootstrap(const MonteCarloSpec& spec = {}, unsigned threads = 0)
+        : spec_(spec), threads_(threads == 0 ? defaultThreadCount() : threads) {}
+    
+    const MonteCarloSpec& getSpec() const { return spec_; }
+    
+    /**
+     * @brief Simulate every path; empty result if there are no trades
+     */
+    MonteCarloPaths simulate(const std::vector<double>& pnls, double initial_capital) const {
+        MonteCarloPaths out;
+        if (pnls.empty() || spec_.paths == 0) return out;
+        if (pnls.size() > 0xFFFFFFFFu) {
+            throw std::invalid_argument("Monte Carlo sample too large");
+        }
+        
+        out.final_capital.resize(spec_.paths);
+        out.max_drawdown.resize(spec_.paths);
+        out.ruined.resize(spec_.paths);
+        
+        const std::size_t jobs = (spec_.paths + PATHS_PER_JOB - 1) / PATHS_PER_JOB;
+        parallelFor(jobs, threads_, [&](std::size_t job, unsigned) {
+            std::size_t begin = job * PATHS_PER_JOB;
+            std::size_t end = std::min(spec_.paths, begin + PATHS_PER_JOB);
+            simulate(pnls, initial_capital, begin, end, out);
+        });
+        return out;
+    }
+    
+    MonteCarloSummary summarize(const std::vector<double>& pnls, double initial_capital) const {
+        MonteCarloSummary summary;
+        summary.paths = spec_.paths;
+        summary.initial_capital = initial_capital;
+        
+        // No trades: every path stays flat at the initial capital
+        MonteCarloPaths paths = simulate(pnls, initial_capital);
+        if (paths.final_capital.empty()) {
+            summary.mean_final_capital = summary.final_capital_p5 =
+                summary.final_capital_p50 = summary.final_capital_p95 = initial_capital;
+            return summary;
+        }
+        
+        summary.trades_per_path = spec_.trades_per_path ? spec_.trades_per_path : pnls.size();
+        
+        double total = 0.0;
+        std::size_t ruined = 0;
+        for (std::size_t p = 0; p < summary.paths; ++p) {
+            total += paths.final_capital[p];
+            ruined += paths.ruined[p];
+        }
+        summary.mean_final_capital = total / summary.paths;
+        summary.ruin_probability = static_cast<double>(ruined) / summary.paths;
+        
+        std::sort(paths.final_capital.begin(), paths.final_capital.end());
+        std::sort(paths.max_drawdown.begin(), paths.max_drawdown.end());
+        summary.final_capital_p5 = percentile(paths.final_capital, 0.05);
+        summary.final_capital_p50 = percentile(paths.final_capital, 0.50);
+        summary.final_capital_p95 = percentile(paths.final_capital, 0.95);
+        summary.max_drawdown_p50 = percentile(paths.max_drawdown, 0.50);
+        summary.max_drawdown_p95 = percentile(paths.max_drawdown, 0.95);
+        return summary;
+    }
+};
+
+#endif // MONTE_CARLO_HPP
@@ -0,0 +1,240 @@
+#ifndef MULTI_STRATEGY_HOST_HPP
+#define MULTI_STRATEGY_HOST_HPP
+
+#include <cstdint>
+#include <stdexcept>
+#include <vector>
+#include "backtest_kernel.hpp"
+#include "candle_columns.hpp"
+#include "pattern_batch.hpp"
+#include "trading_engine.hpp"
+
+/**
+ * @file multi_strategy_host.hpp
+ * @brief Many independent strategy/risk/position instances on one stream
+ * 
+ * Running 200 TradingEngine objects means 200 copies of the candle stream,
+ * 200 EMA sets and pointer-chasing between objects on every candle. The
+ * host instead keeps every instance's state in contiguous per-field arrays
+ * (structure of arrays) and advances all instances per candle in a few
+ * tight loops:
+ * 
+ *   1. Shared indicators: one IndicatorRegistry, one update per unique EMA
+ *   2. Strategy step: PatternBatch::stepWithEMA over all instances
+ *   3. Exit test: branch-free flags; rare exits handled afterwards
+ *   4. Entries: branch-free eligibility; rare fills handled afterwards
+ * 
+ * Each instance behaves exactly like TradingEngine with the same
+ * StrategyParams / RiskParams / market close, and keeps its own trade log.
+ */
+
+/**
+ * @class MultiStrategyHost
+ * @brief SoA host for M TwoCandelPattern + RiskManager variants
+ */
+class MultiStrategyHost {
+private:
+    std::vector<BacktestConfig> configs_;
+    IndicatorRegistry indicators_;
+    std::vector<IndicatorHandle> ema_handle_;
+    PatternBatch pattern_;                    // Arm/fire state, one lane per instance
+    
+    // Per-instance parameters
+    std::vector<double> stop_loss_;
+    std::vector<double> take_profit_;
+    std::vector<int> max_trades_;
+    std::vector<int> close_minute_;
+    
+    // Per-instance state
+    std::vector<double> open_;                // Candle broadcast to every lane
+    std::vector<double> low_;
+    std::vector<double> ema_;
+    std::vector<std::uint8_t> active_;        // Session still running
+    std::vector<std::uint8_t> position_open_;
+    std::vector<double> entry_price_;
+    std::vector<int> quantity_;
+    std::vector<int> trades_;
+    std::vector<double> initial_capital_;
+    std::vector<double> capital_;
+    std::vector<double> peak_capital_;
+    std::vector<std::uint8_t> exit_flag_;     // 1 = SL/TP, 2 = market close
+    std::vector<std::uint8_t> enter_flag_;
+    
+    std::vector<RunSummary> summaries_;
+    std::vector<std::vector<Trade>> trade_logs_;
+    
+    void closePosition(std::size_t k, const Candle& candle) {
+        double pnl = (entry_price_[k] - candle.close) * quantity_[k];
+        capital_[k] += pnl;
+        peak_capital_[k] = std::max(peak_capital_[k], capital_[k]);
+        
+        RunSummary& summary = summaries_[k];
+        summary.wins += pnl > 0;
+        summary.losses += pnl < 0;
+        summary.max_drawdown = std::max(summary.max_drawdown, peak_capital_[k] - capital_[k]);
+        
+        trade_logs_[k].emplace_back(candle.timestamp, Trade::Side::SELL, Trade::Type::EXIT,
+                                    candle.close, quantity_[k], pnl);
+        position_open_[k] = 0;
+    }
+    
+    static std::vector<StrategyParams> strategyParams(const std::vector<BacktestConfig>& configs) {
+        std::vector<StrategyParams> params;
+        params.reserve(configs.size());
+        for (const auto& config : configs) params.push_back(config.strategy);
+        return params;
+    }
+    
+public:
+    explicit MultiStrategyHost(const std::vector<BacktestConfig>& configs)
+        : configs_(configs), pattern_(strategyParams(configs)) {
+        const std::size_t m = configs.size();
+        ema_handle_.reserve(m);
+        for (const auto& config : configs) {
+            ema_handle_.push_back(indicators_.request(
+                IndicatorType::EMA, config.strategy.ema_slow_period, PriceSource::CLOSE));
+        }
+        
+        stop_loss_.resize(m);
+        take_profit_.resize(m);
+        max_trades_.resize(m);
+        close_minute_.resize(m);
+        open_.resize(m);
+        low_.resize(m);
+        ema_.resize(m);
+        active_.resize(m);
+        position_open_.resize(m);
+        entry_price_.resize(m);
+        quantity_.resize(m);
+        trades_.resize(m);
+        initial_capital_.resize(m);
+        capital_.resize(m);
+        peak_capital_.resize(m);
+        exit_flag_.resize(m);
+        enter_flag_.resize(m);
+        summaries_.resize(m);
+        trade_logs_.resize(m);
+    }
+    
+    MultiStrategyHost(const MultiStrategyHost&) = delete;
+    MultiStrategyHost& operator=(const MultiStrategyHost&) = delete;
+    
+    /**
+     * @brief Reset every instance for a new session
+     */
+    void beginSession(double previous_day_close, double capital) {
+        indicators_.reset();
+        for (std::size_t k = 0; k < configs_.size(); ++k) {
+            const BacktestConfig& config = configs_[k];
+            pattern_.beginSession(k, previous_day_close);
+            stop_loss_[k] = capital * config.risk.stop_loss_pct;
+            take_profit_[k] = capital * config.risk.take_profit_pct;
+            max_trades_[k] = config.risk.max_daily_trades;
+            close_minute_[k] = config.risk.market_close_minute;
+            
+            active_[k] = 1;
+            position_open_[k] = 0;
+            entry_price_[k] = 0.0;
+            quantity_[k] = 0;
+            trades_[k] = 0;
+            initial_capital_[k] = capital;
+            capital_[k] = capital;
+            peak_capital_[k] = capital;
+            
+            summaries_[k] = RunSummary();
+            summaries_[k].initial_capital = capital;
+            summaries_[k].final_capital = capital;
+            trade_logs_[k].clear();
+        }
+    }
+    
+    /**
+     * @brief Advance every instance by one candle
+     */
+    void onCandle(const Candle& candle) {
+        const std::size_t m = configs_.size();
+        const int minute = parseMinuteOfDay(candle.timestamp);
+        const double open = candle.open;
+        const double low = candle.low;
+        const double close = candle.close;
+        
+        // 1. Shared indicators, then gather per instance
+        indicators_.update(candle);
+        for (std::size_t k = 0; k < m; ++k) ema_[k] = indicators_.value(ema_handle_[k]);
+        std::fill(open_.begin(), open_.end(), open);
+        std::fill(low_.begin(), low_.end(), low);
+        
+        // 2. Strategy state machine (shared with PatternBatch)
+        const std::uint64_t* signal = pattern_.stepWithEMA(open_.data(), low_.data(), ema_.data());
+        
+        // 3. Exit flags, branch-free; act on the (rare) set flags
+        bool any_exit = false;
+        for (std::size_t k = 0; k < m; ++k) {
+            const double unrealized = (entry_price_[k] - close) * quantity_[k];
+            const std::uint8_t live = static_cast<std::uint8_t>(position_open_[k] & active_[k]);
+            const std::uint8_t hit = static_cast<std::uint8_t>(
+                (unrealized <= -stop_loss_[k]) | (unrealized >= take_profit_[k]));
+            const std::uint8_t cutoff = static_cast<std::uint8_t>(minute >= close_minute_[k]);
+            exit_flag_[k] = static_cast<std::uint8_t>(live * (hit ? 1 : cutoff * 2));
+            any_exit |= exit_flag_[k] != 0;
+        }
+        if (any_exit) {
+            for (std::size_t k = 0; k < m; ++k) {
+                if (!exit_flag_[k]) continue;
+                closePosition(k, candle);
+                if (exit_flag_[k] == 2) active_[k] = 0;  // Session over
+            }
+        }
+        
+        // 4. Entry eligibility, branch-free; fill the (rare) eligible ones
+        bool any_entry = false;
+        for (std::size_t k = 0; k < m; ++k) {
+            enter_flag_[k] = static_cast<std::uint8_t>(
+                ((signal[k / 64] >> (k % 64)) & 1) & active_[k] & !position_open_[k] & (trades_[k] < max_trades_[k]));
+            any_entry |= enter_flag_[k] != 0;
+        }
+        if (any_entry) {
+            for (std::size_t k = 0; k < m; ++k) {
+                if (!enter_flag_[k]) continue;
+                int qty = close > 0 ? static_cast<int>(capital_[k] / close) : 0;
+                if (qty <= 0) continue;
+                position_open_[k] = 1;
+                entry_price_[k] = close;
+                quantity_[k] = qty;
+                ++trades_[k];
+                trade_logs_[k].emplace_back(candle.timestamp, Trade::Side::SELL,
+                                            Trade::Type::ENTRY, close, qty);
+            }
+        }
+    }
+    
+    /**
+     * @brief Square off open positions at the last candle and finalise summaries
+     */
+    void endSession(const Candle& last_candle) {
+        for (std::size_t k = 0; k < configs_.size(); ++k) {
+            if (position_open_[k]) closePosition(k, last_candle);
+            summaries_[k].trades = trades_[k];
+            summaries_[k].final_capital = capital_[k];
+        }
+    }
+    
+    /**
+     * @brief Convenience: run a whole session through every instance
+     */
+    void runSession(const MarketData& data) {
+        beginSession(data.previous_day_close, data.capital);
+        for (const auto& candle : data.candles) onCandle(candle);
+        if (!data.candles.empty()) endSession(data.candles.back());
+    }
+    
+    std::size_t size() const { return configs_.size(); }
+    std::size_t uniqueIndicators() const { return indicators_.size(); }
+    const BacktestConfig& getConfig(std::size_t k) const { return configs_[k]; }
+    const RunSummary& getSummary(std::size_t k) const { return summaries_[k]; }
+    const std::vector<Trade>& getTradeLog(std::size_t k) const { return trade_logs_[k]; }
+    double getCapital(std::size_t k) const { return capital_[k]; }
+    bool isPositionOpen(std::size_t k) const { return position_open_[k] != 0; }
+};
+
+#endif // MULTI_STRATEGY_HOST_HPP
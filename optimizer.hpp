@@ -0,0 +1,239 @@
+#ifndef OPTIMIZER_HPP
+#define OPTIMIZER_HPP
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <set>
+#include <stdexcept>
+#include <vector>
+#include "parameter_sweep.hpp"
+
+/**
+ * @file optimizer.hpp
+ * @brief Successive halving with evolutionary refinement over a SweepSpec grid
+ * 
+ * With every parameter free (gap, slow EMA, SL, TP, max trades, market
+ * close) the grid has tens of thousands of points; running each on every
+ * session is wasteful because most are clearly dominated after a handful
+ * of sessions.
+ * 
+ * ALGORITHM (rung r evaluates the first min_sessions * eta^r sessions):
+ * 1. Sample `population` distinct grid points
+ * 2. Bring every live candidate up to the rung's session budget. Results
+ *    are incremental: a candidate only runs sessions it has not seen yet
+ * 3. Rank (isBetterResult) and keep the best 1/eta; everything else is
+ *    terminated
+ * 4. The best 1/eta of the survivors each spawn `mutants` unseen grid
+ *    neighbours (one axis moved one step) that join the next rung
+ * 5. Once a rung covers every session, hill-climb: evaluate the leader's
+ *    unseen axis neighbours on every session and repeat until the leader
+ *    stops changing (or `max_refinements` steps)
+ * 
+ * Sessions are visited in a seeded shuffled order so that small budgets
+ * see a representative mix. Candidate runs go through ParameterSweep's
+ * cached evaluate() on the shared parallelFor workers; results depend
+ * only on the seed, not the thread count.
+ */
+
+struct OptimizerSpec {
+    std::size_t population = 0;     // 0 = 1% of the grid (at least 16)
+    std::size_t min_sessions = 0;   // First-rung session budget; 0 = 10% (at least 8)
+    std::size_t eta = 3;            // Keep 1/eta per rung
+    std::size_t mutants = 2;        // Neighbours spawned per elite survivor
+    std::size_t max_refinements = 64;  // Hill-climbing steps at the full budget
+    std::uint64_t seed = 42;
+};
+
+struct OptimizerResult {
+    std::vector<SweepResult> finalists;  // Last rung, best first (all sessions, shuffled order)
+    std::size_t candidates = 0;          // Distinct grid points evaluated
+    std::size_t session_runs = 0;        // Backtests actually executed
+    std::size_t grid_size = 0;
+    std::size_t grid_session_runs = 0;   // Exhaustive sweep cost, for comparison
+    std::size_t rungs = 0;
+    
+    double evaluationFraction() const {
+        return grid_session_runs ? static_cast<double>(session_runs) / grid_session_runs : 0.0;
+    }
+};
+
+/**
+ * @class SuccessiveHalvingOptimizer
+ * @brief Budgeted search for the best configuration of a SweepSpec grid
+ */
+class SuccessiveHalvingOptimizer {
+private:
+    struct Candidate {
+        SweepPoint point;
+        BacktestConfig config;
+        SweepAccumulator stats;
+        std::size_t sessions_done = 0;
+    };
+    
+    const MarketUniverse& universe_;
+    ParameterSweep sweep_;
+    OptimizerSpec spec_;
+    
+    static std::size_t pointIndex(const SweepSpec::Axes& axes, const SweepPoint& point) {
+        std::size_t index = 0;
+        for (std::size_t a = 0; a < SweepSpec::AXES; ++a) {
+            index = index * axes[a].size() + point[a];
+        }
+        return index;
+    }
+    
+    /**
+     * @brief Run every candidate up to `budget` sessions of `order`; returns runs executed
+     */
+    std::size_t advance(std::vector<Candidate>& candidates, const std::vector<std::size_t>& order,
+                        std::size_t budget) const {
+        parallelFor(candidates.size(), sweep_.threadCount(), [&](std::size_t k, unsigned) {
+            Candidate& candidate = candidates[k];
+            for (std::size_t s = candidate.sessions_done; s < budget; ++s) {
+                candidate.stats.add(sweep_.evaluate(candidate.config, order[s]));
+            }
+        });
+        std::size_t runs = 0;
+        for (auto& candidate : candidates) {
+            runs += budget - candidate.sessions_done;
+            candidate.sessions_done = budget;
+        }
+        return runs;
+    }
+    
+    static void rank(std::vector<Candidate>& candidates) {
+        // Ties keep the earlier candidate
+        std::stable_sort(candidates.begin(), candidates.end(),
+                         [](const Candidate& a, const Candidate& b) {
+            return isBetterResult(a.stats, b.stats);
+        });
+    }
+    
+    static SweepPoint pointAt(const SweepSpec::Axes& axes, std::size_t index) {
+        SweepPoint point{};
+        for (std::size_t a = SweepSpec::AXES; a-- > 0;) {
+            point[a] = index % axes[a].size();
+            index /= axes[a].size();
+        }
+        return point;
+    }
+    
+public:
+    SuccessiveHalvingOptimizer(const MarketUniverse& universe, IndicatorSeriesCache& cache,
+                               const OptimizerSpec& spec = {}, unsigned threads = 0)
+        : universe_(universe), sweep_(universe, cache, threads), spec_(spec) {
+        if (spec_.eta < 2) {
+            throw std::invalid_argument("Successive halving needs eta >= 2");
+        }
+    }
+    
+    OptimizerResult run(const SweepSpec& search) const {
+        OptimizerResult result;
+        const SweepSpec::Axes axes = search.axes();
+        const std::size_t sessions = universe_.size();
+        result.grid_size = SweepSpec::gridSize(axes);
+        result.grid_session_runs = result.grid_size * sessions;
+        if (sessions == 0) return result;
+        
+        std::mt19937_64 rng(spec_.seed);
+        
+        // Shuffled session order shared by every candidate
+        std::vector<std::size_t> order(sessions);
+        for (std::size_t s = 0; s < sessions; ++s) order[s] = s;
+        std::shuffle(order.begin(), order.end(), rng);
+        
+        // 1. Initial population: distinct grid points
+        std::size_t population = spec_.population;
+        if (population == 0) population = std::max<std::size_t>(result.grid_size / 100, 16);
+        population = std::min(population, result.grid_size);
+        
+        std::set<std::size_t> seen;
+        std::vector<Candidate> live;
+        std::uniform_int_distribution<std::size_t> pick(0, result.grid_size - 1);
+        while (live.size() < population) {
+            std::size_t index = population == result.grid_size ? live.size() : pick(rng);
+            if (!seen.insert(index).second) continue;
+            Candidate candidate;
+            candidate.point = pointAt(axes, index);
+            candidate.config = search.configAt(axes, candidate.point);
+            live.push_back(candidate);
+        }
+        
+        // Too few sessions in the first rung and noise decides who survives
+        std::size_t budget = spec_.min_sessions ? spec_.min_sessions
+                                                : std::max<std::size_t>(sessions / 10, 8);
+        budget = std::min(sessions, budget);
+        while (true) {
+            ++result.rungs;
+            
+            // 2. Bring every live candidate up to the rung budget
+            result.session_runs += advance(live, order, budget);
+            
+            // 3. Rank and terminate the dominated
+            rank(live);
+            if (budget == sessions) break;
+            
+            std::size_t keep = (live.size() + spec_.eta - 1) / spec_.eta;
+            live.resize(keep);
+            
+            // 4. Elite survivors spawn unseen neighbours
+            std::size_t elite = (keep + spec_.eta - 1) / spec_.eta;
+            for (std::size_t e = 0; e < elite; ++e) {
+                for (std::size_t m = 0; m < spec_.mutants; ++m) {
+                    SweepPoint point = live[e].point;
+                    std::size_t axis = static_cast<std::size_t>(rng() % SweepSpec::AXES);
+                    if (axes[axis].size() < 2) continue;
+                    bool up = (rng() & 1) != 0;
+                    if (up ? point[axis] + 1 >= axes[axis].size() : point[axis] == 0) up = !up;
+                    point[axis] = up ? point[axis] + 1 : point[axis] - 1;
+                    
+                    if (!seen.insert(pointIndex(axes, point)).second) continue;
+                    Candidate candidate;
+                    candidate.point = point;
+                    candidate.config = search.configAt(axes, point);
+                    live.push_back(candidate);
+                }
+            }
+            
+            // A lone survivor goes straight to the full session set
+            budget = live.size() <= 1 ? sessions : std::min(sessions, budget * spec_.eta);
+        }
+        
+        // 5. Hill-climb around the leader at the full budget
+        for (std::size_t step = 0; step < spec_.max_refinements; ++step) {
+            std::vector<Candidate> neighbours;
+            for (std::size_t axis = 0; axis < SweepSpec::AXES; ++axis) {
+                for (int direction : {-1, 1}) {
+                    SweepPoint point = live.front().point;
+                    if (direction < 0 ? point[axis] == 0 : point[axis] + 1 >= axes[axis].size()) {
+                        continue;
+                    }
+                    point[axis] = direction < 0 ? point[axis] - 1 : point[axis] + 1;
+                    if (!seen.insert(pointIndex(axes, point)).second) continue;
+                    Candidate candidate;
+                    candidate.point = point;
+                    candidate.config = search.configAt(axes, point);
+                    neighbours.push_back(candidate);
+                }
+            }
+            if (neighbours.empty()) break;
+            
+            result.session_runs += advance(neighbours, order, sessions);
+            ++result.rungs;
+            live.insert(live.end(), neighbours.begin(), neighbours.end());
+            
+            SweepPoint leader = live.front().point;
+            rank(live);
+            if (live.front().point == leader) break;  // Local optimum
+        }
+        
+        result.candidates = seen.size();
+        for (const auto& candidate : live) {
+            result.finalists.push_back({candidate.config, candidate.stats, MonteCarloSummary()});
+        }
+        return result;
+    }
+};
+
+#endif // OPTIMIZER_HPP
@@ -0,0 +1,600 @@
+#ifndef ORDER_BOOK_HPP
+#define ORDER_BOOK_HPP
+
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include "binary_io.hpp"
+
+/**
+ * @file order_book.hpp
+ * @brief L2 order book replay with simulated fills for our own orders
+ * 
+ * TradingEngine fills every order in full at the candle close. For size
+ * that matters, OrderBookSim replays recorded market depth (L2 snapshots
+ * and per-level deltas, plus trade prints) and matches our orders against
+ * it: market orders walk the opposite side, limit orders rest at their
+ * price behind the depth that was already there.
+ * 
+ * LAYOUT:
+ * Prices map to tick indices of a fixed ladder, [min_price, max_price] in
+ * steps of tick_size. Each side is an array of levels indexed by tick, so
+ * a depth update is an index computation and a store, with no search
+ * or allocation. Our resting orders come from a pool (free list, reused
+ * slots) and are linked into their level's FIFO through indices stored
+ * in the orders themselves.
+ * 
+ * QUEUE POSITION:
+ * An order that rests on a level has the level's displayed depth ahead
+ * of it. Trades printed at its price consume the queue ahead, then the
+ * order. A depth decrease the trades do not explain is treated as
+ * cancellations spread evenly over the queue, so it shrinks the queue
+ * ahead in proportion. A market quote that crosses a resting order fills
+ * it at its own price.
+ * 
+ * Market depth is not reduced by our own resting fills; our taker fills
+ * consume local depth until the next update for that level replaces it.
+ */
+
+enum class BookSide : std::uint8_t { BID, ASK };
+enum class OrderSide : std::uint8_t { BUY, SELL };
+
+/**
+ * @brief One market data record
+ * 
+ * LEVEL sets the depth at a price (0 removes it); CLEAR empties the book
+ * before a snapshot; TRADE is a print against the resting `side` (BID:
+ * a seller hit the bids).
+ */
+struct BookEvent {
+    enum class Type : std::uint8_t { CLEAR, LEVEL, TRADE };
+    
+    std::int64_t timestamp_ms;  // Milliseconds since midnight
+    Type type;
+    BookSide side;
+    double price;
+    double quantity;
+};
+
+/**
+ * @brief Execution of one of our orders
+ */
+struct BookFill {
+    std::uint64_t order_id;
+    std::int64_t timestamp_ms;
+    double price;
+    std::int64_t quantity;
+    bool maker;                 // Resting order filled (false: took liquidity)
+};
+
+namespace order_book_detail {
+
+constexpr std::uint32_t NIL = std::numeric_limits<std::uint32_t>::max();
+
+struct Level {
+    std::int64_t depth = 0;     // Displayed market quantity
+    std::int64_t traded = 0;    // Printed since the last depth update
+    std::uint32_t head = NIL;   // Our orders, oldest first
+    std::uint32_t tail = NIL;
+};
+
+struct Order {
+    std::uint64_t id = 0;
+    std::int64_t remaining = 0;
+    std::int64_t queue_ahead = 0;   // Market quantity ahead in the level's FIFO
+    std::int32_t level = 0;
+    BookSide side = BookSide::BID;
+    bool active = false;
+    std::uint32_t prev = NIL;
+    std::uint32_t next = NIL;
+};
+
+} // namespace order_book_detail
+
+// ============================================================================
+// ORDER BOOK SIMULATOR
+// ============================================================================
+
+/**
+ * @class OrderBookSim
+ * @brief Array-ladder L2 book with pooled, queue-tracked simulated orders
+ * 
+ * Order ids combine the pool slot (low 32 bits) with a sequence number,
+ * so an id stays unique after its slot is reused.
+ */
+class OrderBookSim {
+private:
+    using Level = order_book_detail::Level;
+    using Order = order_book_detail::Order;
+    static constexpr std::uint32_t NIL = order_book_detail::NIL;
+    
+    double min_price_;
+    double tick_size_;
+    std::int32_t levels_;
+    
+    std::vector<Level> ladder_[2];      // Indexed by BookSide
+    std::int32_t best_[2];              // Best market level per side
+    std::int32_t own_best_[2];          // Best level holding one of our orders
+    
+    std::vector<Order> pool_;
+    std::vector<std::uint32_t> free_;
+    std::uint64_t sequence_ = 0;
+    
+    std::vector<BookFill> fills_;
+    std::uint64_t events_ = 0;
+    std::uint64_t ignored_ = 0;
+    
+    static std::size_t idx(BookSide side) { return static_cast<std::size_t>(side); }
+    static BookSide opposite(BookSide side) {
+        return side == BookSide::BID ? BookSide::ASK : BookSide::BID;
+    }
+    static BookSide restingSide(OrderSide side) {
+        return side == OrderSide::BUY ? BookSide::BID : BookSide::ASK;
+    }
+    
+    // Bids improve upwards, asks downwards
+    std::int32_t none(BookSide side) const { return side == BookSide::BID ? -1 : levels_; }
+    static std::int32_t worseStep(BookSide side) { return side == BookSide::BID ? -1 : 1; }
+    bool valid(std::int32_t level) const { return level >= 0 && level < levels_; }
+    static bool atLeastAsGood(BookSide side, std::int32_t a, std::int32_t b) {
+        return side == BookSide::BID ? a >= b : a <= b;
+    }
+    
+    /**
+     * @brief A bid level and an ask level that would trade with each other
+     */
+    static bool crosses(std::int32_t bid_level, std::int32_t ask_level) {
+        return bid_level >= ask_level;
+    }
+    
+    std::int32_t toLevel(double price) const {
+        const double offset = (price - min_price_) / tick_size_;
+        if (!(offset > -0.5 && offset < levels_ - 0.5)) return -1;
+        return static_cast<std::int32_t>(std::llround(offset));
+    }
+    
+    void rescanBest(BookSide side, std::int32_t from) {
+        const std::vector<Level>& ladder = ladder_[idx(side)];
+        std::int32_t level = from;
+        while (valid(level) && ladder[level].depth <= 0) level += worseStep(side);
+        best_[idx(side)] = valid(level) ? level : none(side);
+    }
+    
+    void rescanOwnBest(BookSide side, std::int32_t from) {
+        const std::vector<Level>& ladder = ladder_[idx(side)];
+        std::int32_t level = from;
+        while (valid(level) && ladder[level].head == NIL) level += worseStep(side);
+        own_best_[idx(side)] = valid(level) ? level : none(side);
+    }
+    
+    /**
+     * @brief Live resting order, or nullptr
+     */
+    const Order* find(std::uint64_t id) const {
+        const std::size_t slot = static_cast<std::size_t>(id & 0xffffffffu);
+        if (slot >= pool_.size() || !pool_[slot].active || pool_[slot].id != id) return nullptr;
+        return &pool_[slot];
+    }
+    
+    std::uint32_t allocate(BookSide side, std::int32_t level, std::int64_t quantity) {
+        std::uint32_t slot;
+        if (!free_.empty()) {
+            slot = free_.back();
+            free_.pop_back();
+        } else {
+            if (pool_.size() >= NIL) throw std::length_error("Order pool exhausted");
+            slot = static_cast<std::uint32_t>(pool_.size());
+            pool_.emplace_back();
+        }
+        Order& order = pool_[slot];
+        order = Order();
+        order.id = (++sequence_ << 32) | slot;
+        order.remaining = quantity;
+        order.level = level;
+        order.side = side;
+        order.active = true;
+        return slot;
+    }
+    
+    void release(std::uint32_t slot) {
+        pool_[slot].active = false;
+        free_.push_back(slot);
+    }
+    
+    void enqueue(std::uint32_t slot) {
+        Order& order = pool_[slot];
+        Level& level = ladder_[idx(order.side)][order.level];
+        order.queue_ahead = level.depth;
+        order.prev = level.tail;
+        order.next = NIL;
+        if (level.tail != NIL) pool_[level.tail].next = slot;
+        else level.head = slot;
+        level.tail = slot;
+        
+        std::int32_t& own_best = own_best_[idx(order.side)];
+        if (!valid(own_best) || !atLeastAsGood(order.side, own_best, order.level)) {
+            own_best = order.level;
+        }
+    }
+    
+    void unlink(std::uint32_t slot) {
+        Order& order = pool_[slot];
+        Level& level = ladder_[idx(order.side)][order.level];
+        if (order.prev != NIL) pool_[order.prev].next = order.next;
+        else level.head = order.next;
+        if (order.next != NIL) pool_[order.next].prev = order.prev;
+        else level.tail = order.prev;
+        
+        if (level.head == NIL && own_best_[idx(order.side)] == order.level) {
+            rescanOwnBest(order.side, order.level);
+        }
+    }
+    
+    double priceOf(std::int32_t level) const { return min_price_ + level * tick_size_; }
+    
+    /**
+     * @brief Record a fill; a resting order that completes leaves its queue
+     */
+    void fill(std::uint32_t slot, std::int64_t timestamp_ms, std::int32_t level,
+              std::int64_t quantity, bool maker) {
+        Order& order = pool_[slot];
+        fills_.push_back(BookFill{order.id, timestamp_ms, priceOf(level), quantity, maker});
+        order.remaining -= quantity;
+        if (order.remaining == 0 && maker) {
+            unlink(slot);
+            release(slot);
+        }
+    }
+    
+    /**
+     * @brief Trade volume at one of our levels, in FIFO order
+     * @param honor_queue False when the print was at a worse price (the
+     *        market had nothing ahead of us here)
+     * @return Volume left over after our orders
+     */
+    std::int64_t fillQueue(BookSide side, std::int32_t level, std::int64_t volume,
+                           std::int64_t timestamp_ms, bool honor_queue) {
+        std::int64_t eaten = 0;
+        std::uint32_t slot = ladder_[idx(side)][level].head;
+        while (slot != NIL && volume > 0) {
+            const std::uint32_t next = pool_[slot].next;
+            if (honor_queue) {
+                const std::int64_t gap = std::max<std::int64_t>(0, pool_[slot].queue_ahead - eaten);
+                if (volume <= gap) {
+                    eaten += volume;
+                    volume = 0;
+                    break;
+                }
+                volume -= gap;
+                eaten += gap;
+            }
+            const std::int64_t quantity = std::min(volume, pool_[slot].remaining);
+            volume -= quantity;
+            fill(slot, timestamp_ms, level, quantity, true);
+            slot = next;
+        }
+        if (eaten > 0) {
+            for (slot = ladder_[idx(side)][level].head; slot != NIL; slot = pool_[slot].next) {
+                pool_[slot].queue_ahead = std::max<std::int64_t>(0, pool_[slot].queue_ahead - eaten);
+            }
+        }
+        return volume;
+    }
+    
+    void onTrade(BookSide side, std::int32_t level, std::int64_t volume, std::int64_t timestamp_ms) {
+        ladder_[idx(side)][level].traded += volume;
+        for (std::int32_t own = own_best_[idx(side)];
+             volume > 0 && valid(own) && atLeastAsGood(side, own, level);
+             own += worseStep(side)) {
+            if (ladder_[idx(side)][own].head == NIL) continue;
+            volume = fillQueue(side, own, volume, timestamp_ms, own == level);
+        }
+    }
+    
+    /**
+     * @brief Depth change at a level holding our orders: unexplained decrease is cancels
+     */
+    void onDepthChange(Level& level, std::int64_t new_depth) {
+        const std::int64_t decrease = level.depth - new_depth;
+        const std::int64_t cancelled = decrease - std::min(decrease, level.traded);
+        const std::int64_t base = level.depth - std::min(decrease, level.traded);
+        for (std::uint32_t slot = level.head; slot != NIL; slot = pool_[slot].next) {
+            std::int64_t& ahead = pool_[slot].queue_ahead;
+            if (cancelled > 0 && base > 0) {
+                ahead -= static_cast<std::int64_t>(std::llround(
+                    static_cast<double>(ahead) * static_cast<double>(cancelled) / base));
+            }
+            ahead = std::max<std::int64_t>(0, std::min(ahead, new_depth));
+        }
+    }
+    
+    /**
+     * @brief Fill our resting orders on `side` that a market quote now crosses
+     */
+    void matchCrossed(BookSide side, std::int64_t timestamp_ms) {
+        const BookSide market = opposite(side);
+        std::vector<Level>& quotes = ladder_[idx(market)];
+        while (valid(own_best_[idx(side)]) && valid(best_[idx(market)])) {
+            const std::int32_t own = own_best_[idx(side)];
+            const std::int32_t quote = best_[idx(market)];
+            if (!(side == BookSide::BID ? crosses(own, quote) : crosses(quote, own))) break;
+            
+            const std::uint32_t slot = ladder_[idx(side)][own].head;
+            const std::int64_t quantity = std::min(pool_[slot].remaining, quotes[quote].depth);
+            quotes[quote].depth -= quantity;
+            if (quotes[quote].depth == 0) rescanBest(market, quote);
+            fill(slot, timestamp_ms, own, quantity, true);
+        }
+    }
+    
+    /**
+     * @brief Take liquidity up to `limit_level` (none() of the book side: no limit)
+     */
+    void take(std::uint32_t slot, std::int32_t limit_level, std::int64_t timestamp_ms) {
+        const BookSide side = pool_[slot].side;
+        const BookSide market = opposite(side);
+        std::vector<Level>& quotes = ladder_[idx(market)];
+        while (pool_[slot].remaining > 0 && valid(best_[idx(market)])) {
+            const std::int32_t quote = best_[idx(market)];
+            if (valid(limit_level) &&
+                !(side == BookSide::BID ? crosses(limit_level, quote) : crosses(quote, limit_level))) {
+                break;
+            }
+            const std::int64_t quantity = std::min(pool_[slot].remaining, quotes[quote].depth);
+            quotes[quote].depth -= quantity;
+            if (quotes[quote].depth == 0) rescanBest(market, quote);
+            fill(slot, timestamp_ms, quote, quantity, false);
+        }
+    }
+    
+public:
+    /**
+     * @param min_price, max_price Ladder range; updates outside it are ignored
+     * @param tick_size Price increment of the instrument
+     * @param reserve_orders Pool slots allocated up front
+     */
+    OrderBookSim(double min_price, double max_price, double tick_size,
+                 std::size_t reserve_orders = 1024)
+        : min_price_(min_price), tick_size_(tick_size) {
+        if (!(tick_size > 0) || !(max_price >= min_price)) {
+            throw std::invalid_argument("Invalid order book price ladder");
+        }
+        const double levels = std::floor((max_price - min_price) / tick_size + 0.5) + 1;
+        if (levels > (1 << 24)) {
+            throw std::invalid_argument("Order book price ladder too large");
+        }
+        levels_ = static_cast<std::int32_t>(levels);
+        ladder_[0].resize(levels_);
+        ladder_[1].resize(levels_);
+        best_[idx(BookSide::BID)] = own_best_[idx(BookSide::BID)] = none(BookSide::BID);
+        best_[idx(BookSide::ASK)] = own_best_[idx(BookSide::ASK)] = none(BookSide::ASK);
+        pool_.reserve(reserve_orders);
+        free_.reserve(reserve_orders);
+    }
+    
+    /**
+     * @brief Apply one market data record
+     */
+    void apply(const BookEvent& event) {
+        ++events_;
+        if (event.type == BookEvent::Type::CLEAR) {
+            for (auto& ladder : ladder_) {
+                for (auto& level : ladder) {
+                    level.depth = 0;
+                    level.traded = 0;
+                }
+            }
+            best_[idx(BookSide::BID)] = none(BookSide::BID);
+            best_[idx(BookSide::ASK)] = none(BookSide::ASK);
+            return;
+        }
+        
+        const std::int32_t level = toLevel(event.price);
+        const std::int64_t quantity = std::max<std::int64_t>(0, std::llround(event.quantity));
+        if (level < 0) {
+            ++ignored_;
+            return;
+        }
+        const BookSide side = event.side;
+        
+        if (event.type == BookEvent::Type::TRADE) {
+            onTrade(side, level, quantity, event.timestamp_ms);
+            return;
+        }
+        
+        Level& entry = ladder_[idx(side)][level];
+        if (entry.head != NIL) onDepthChange(entry, quantity);
+        entry.depth = quantity;
+        entry.traded = 0;
+        
+        std::int32_t& best = best_[idx(side)];
+        if (quantity > 0) {
+            if (!valid(best) || !atLeastAsGood(side, best, level)) best = level;
+            const BookSide own = opposite(side);
+            if (valid(own_best_[idx(own)]) &&
+                (side == BookSide::BID ? crosses(level, own_best_[idx(own)])
+                                       : crosses(own_best_[idx(own)], level))) {
+                matchCrossed(own, event.timestamp_ms);
+            }
+        } else if (level == best) {
+            rescanBest(side, level);
+        }
+    }
+    
+    /**
+     * @brief Market order; any quantity the book cannot fill is cancelled
+     * @return Order id (see fills())
+     */
+    std::uint64_t submitMarket(OrderSide side, std::int64_t quantity, std::int64_t timestamp_ms) {
+        if (quantity <= 0) throw std::invalid_argument("Order quantity must be positive");
+        const BookSide book_side = restingSide(side);
+        const std::uint32_t slot = allocate(book_side, none(book_side), quantity);
+        const std::uint64_t id = pool_[slot].id;
+        take(slot, none(book_side), timestamp_ms);
+        release(slot);
+        return id;
+    }
+    
+    /**
+     * @brief Limit order: takes what crosses, rests the rest at `price`
+     * @return Order id for cancel() / queue queries
+     */
+    std::uint64_t submitLimit(OrderSide side, double price, std::int64_t quantity,
+                              std::int64_t timestamp_ms) {
+        if (quantity <= 0) throw std::invalid_argument("Order quantity must be positive");
+        const std::int32_t level = toLevel(price);
+        if (level < 0) throw std::out_of_range("Limit price outside the order book ladder");
+        
+        const std::uint32_t slot = allocate(restingSide(side), level, quantity);
+        const std::uint64_t id = pool_[slot].id;
+        take(slot, level, timestamp_ms);
+        if (pool_[slot].remaining > 0) enqueue(slot);
+        else release(slot);
+        return id;
+    }
+    
+    /**
+     * @return False if the order already filled or was cancelled
+     */
+    bool cancel(std::uint64_t id) {
+        const Order* order = find(id);
+        if (!order) return false;
+        const std::uint32_t slot = static_cast<std::uint32_t>(id & 0xffffffffu);
+        unlink(slot);
+        release(slot);
+        return true;
+    }
+    
+    std::int64_t remaining(std::uint64_t id) const {
+        const Order* order = find(id);
+        return order ? order->remaining : 0;
+    }
+    
+    std::int64_t queueAhead(std::uint64_t id) const {
+        const Order* order = find(id);
+        return order ? order->queue_ahead : 0;
+    }
+    
+    /**
+     * @brief Best displayed price, NaN if that side is empty
+     */
+    double bestPrice(BookSide side) const {
+        const std::int32_t level = best_[idx(side)];
+        return valid(level) ? priceOf(level) : std::numeric_limits<double>::quiet_NaN();
+    }
+    
+    std::int64_t depthAt(BookSide side, double price) const {
+        const std::int32_t level = toLevel(price);
+        return level < 0 ? 0 : ladder_[idx(side)][level].depth;
+    }
+    
+    const std::vector<BookFill>& fills() const { return fills_; }
+    void clearFills() { fills_.clear(); }
+    
+    std::uint64_t eventsApplied() const { return events_; }
+    std::uint64_t eventsIgnored() const { return ignored_; }
+};
+
+/**
+ * @brief Apply events[next..] up to and including `timestamp_ms`
+ * @return Index of the first event not applied
+ */
+inline std::size_t replayUntil(OrderBookSim& book, const std::vector<BookEvent>& events,
+                               std::size_t next, std::int64_t timestamp_ms) {
+    while (next < events.size() && events[next].timestamp_ms <= timestamp_ms) {
+        book.apply(events[next++]);
+    }
+    return next;
+}
+
+// ============================================================================
+// BOOK EVENT FILES
+// ============================================================================
+
+/**
+ * @brief Load book events from CSV (header optional)
+ * 
+ *   timestamp_ms,C                         clear (snapshot follows)
+ *   timestamp_ms,L,B|A,price,quantity      set depth at a level
+ *   timestamp_ms,T,B|A,price,quantity      trade against bids / asks
+ */
+inline std::vector<BookEvent> loadBookEventsCSV(const std::string& filename) {
+    std::ifstream file(filename);
+    if (!file.is_open()) {
+        throw std::runtime_error("Cannot open file: " + filename);
+    }
+    
+    std::vector<BookEvent> events;
+    std::string line;
+    while (std::getline(file, line)) {
+        if (line.empty() || !std::isdigit(static_cast<unsigned char>(line[0]))) {
+            continue;  // Header or blank
+        }
+        long long ts = 0;
+        char type = 0;
+        char side = 0;
+        BookEvent event{0, BookEvent::Type::CLEAR, BookSide::BID, 0, 0};
+        const int fields = std::sscanf(line.c_str(), "%lld,%c,%c,%lf,%lf",
+                                       &ts, &type, &side, &event.price, &event.quantity);
+        event.timestamp_ms = ts;
+        if (fields >= 2 && type == 'C') {
+            events.push_back(event);
+            continue;
+        }
+        if (fields != 5 || (type != 'L' && type != 'T') || (side != 'B' && side != 'A')) {
+            throw std::runtime_error("Malformed book event line: " + line);
+        }
+        event.type = type == 'L' ? BookEvent::Type::LEVEL : BookEvent::Type::TRADE;
+        event.side = side == 'B' ? BookSide::BID : BookSide::ASK;
+        events.push_back(event);
+    }
+    return events;
+}
+
+/**
+ * @brief Binary archive: u64 count followed by packed (i64, u8, u8, f64, f64) records
+ * 
+ * A full day of L2 deltas loads with a single read.
+ */
+inline void saveBookEventsBinary(const std::string& filename, const std::vector<BookEvent>& events) {
+    BinaryWriter out;
+    out.write(static_cast<std::uint64_t>(events.size()));
+    for (const auto& event : events) {
+        out.write(event.timestamp_ms);
+        out.write(static_cast<std::uint8_t>(event.type));
+        out.write(static_cast<std::uint8_t>(event.side));
+        out.write(event.price);
+        out.write(event.quantity);
+    }
+    writeBinaryFile(filename, out.data());
+}
+
+inline std::vector<BookEvent> loadBookEventsBinary(const std::string& filename) {
+    std::string buffer = readBinaryFile(filename);
+    BinaryReader in(buffer);
+    constexpr std::size_t RECORD_BYTES = sizeof(std::int64_t) + 2 * sizeof(std::uint8_t) +
+                                         2 * sizeof(double);
+    std::vector<BookEvent> events(in.readCount<std::uint64_t>(RECORD_BYTES));
+    for (auto& event : events) {
+        event.timestamp_ms = in.read<std::int64_t>();
+        const std::uint8_t type = in.read<std::uint8_t>();
+        const std::uint8_t side = in.read<std::uint8_t>();
+        if (type > static_cast<std::uint8_t>(BookEvent::Type::TRADE) || side > 1) {
+            throw std::runtime_error("Corrupt book event archive: " + filename);
+        }
+        event.type = static_cast<BookEvent::Type>(type);
+        event.side = static_cast<BookSide>(side);
+        event.price = in.read<double>();
+        event.quantity = in.read<double>();
+    }
+    return events;
+}
+
+#endif // ORDER_BOOK_HPP
@@ -0,0 +1,74 @@
+#ifndef PARALLEL_HPP
+#define PARALLEL_HPP
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * @file parallel.hpp
+ * @brief Minimal fork-join helper for batch workloads
+ * 
+ * Work items are claimed in chunks from a shared atomic counter (dynamic
+ * scheduling), so uneven item costs still balance across cores. Callers
+ * that need reproducible output must write results by item index rather
+ * than by worker.
+ */
+
+inline unsigned defaultThreadCount() {
+    unsigned n = std::thread::hardware_concurrency();
+    return n == 0 ? 1 : n;
+}
+
+/**
+ * @brief Run fn(item, worker) for every item in [0, n) across worker threads
+ * @param threads Worker count (0 = hardware concurrency)
+ * @param chunk Items claimed per counter increment
+ * 
+ * The first exception thrown by any worker is rethrown after all join.
+ */
+template <typename Fn>
+void parallelFor(std::size_t n, unsigned threads, Fn&& fn, std::size_t chunk = 1) {
+    if (n == 0) return;
+    if (threads == 0) threads = defaultThreadCount();
+    chunk = std::max<std::size_t>(chunk, 1);
+    threads = static_cast<unsigned>(
+        std::min<std::size_t>(threads, (n + chunk - 1) / chunk));
+    
+    std::atomic<std::size_t> next{0};
+    std::exception_ptr error;
+    std::mutex error_mutex;
+    
+    auto worker = [&](unsigned worker_id) {
+        try {
+            for (;;) {
+                std::size_t begin = next.fetch_add(chunk, std::memory_order_relaxed);
+                if (begin >= n) break;
+                std::size_t end = std::min(begin + chunk, n);
+                for (std::size_t i = begin; i < end; ++i) fn(i, worker_id);
+            }
+        } catch (...) {
+            std::lock_guard<std::mutex> lock(error_mutex);
+            if (!error) error = std::current_exception();
+            next.store(n, std::memory_order_relaxed);  // Stop other workers early
+        }
+    };
+    
+    if (threads == 1) {
+        worker(0);
+    } else {
+        std::vector<std::thread> pool;
+        pool.reserve(threads - 1);
+        for (unsigned t = 1; t < threads; ++t) pool.emplace_back(worker, t);
+        worker(0);
+        for (auto& thread : pool) thread.join();
+    }
+    
+    if (error) std::rethrow_exception(error);
+}
+
+#endif // PARALLEL_HPP
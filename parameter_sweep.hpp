@@ -0,0 +1,499 @@
+#ifndef PARAMETER_SWEEP_HPP
+#define PARAMETER_SWEEP_HPP
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <fstream>
+#include <iomanip>
+#include <limits>
+#include <memory>
+#include <set>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include "backtest_kernel.hpp"
+#include "indicator_cache.hpp"
+#include "market_universe.hpp"
+#include "monte_carlo.hpp"
+#include "parallel.hpp"
+#include "signal_scan.hpp"
+
+/**
+ * @file parameter_sweep.hpp
+ * @brief Grid sweep over strategy and risk parameters across all cores
+ * 
+ * PIPELINE:
+ * 1. Expand parameter ranges into a configuration grid
+ * 2. Fetch each distinct EMA series once per session from the series cache,
+ *    skipping sessions whose SessionIndex rules out every threshold in the grid
+ * 3. Split (configuration × session-block) jobs across worker threads;
+ *    each job runs the quiet backtest kernel on its sessions
+ * 4. Reduce the per-block partials of each configuration in session order
+ * 5. Optionally bootstrap each configuration's trade P&Ls (monte_carlo.hpp)
+ * 
+ * Results are reproducible regardless of thread count: partials are stored
+ * by job index and reduced in a fixed order.
+ */
+
+/**
+ * @brief Inclusive arithmetic range start, start+step, ..., <= stop
+ * 
+ * A range needs a positive step and stop >= start; anything else throws
+ * std::invalid_argument rather than collapsing to a single point.
+ */
+struct SweepRange {
+    double start;
+    double stop;
+    double step;
+    
+    SweepRange(double value = 0.0) : start(value), stop(value), step(1.0) {}
+    SweepRange(double first, double last, double increment)
+        : start(first), stop(last), step(increment) {
+        if (!(step > 0)) {
+            throw std::invalid_argument("Range step must be positive");
+        }
+        if (stop < start) {
+            throw std::invalid_argument("Range stop is below its start");
+        }
+    }
+    
+    std::vector<double> values() const {
+        // Index-based to avoid accumulating step rounding error
+        std::size_t count = static_cast<std::size_t>(
+            std::floor((stop - start) / step + 1e-9)) + 1;
+        std::vector<double> out;
+        out.reserve(count);
+        for (std::size_t k = 0; k < count; ++k) {
+            out.push_back(start + static_cast<double>(k) * step);
+        }
+        return out;
+    }
+    
+    /**
+     * @brief Parse "value" or "start:stop:step"
+     */
+    static SweepRange parse(const std::string& text) {
+        std::size_t a = text.find(':');
+        if (a == std::string::npos) return SweepRange(std::stod(text));
+        std::size_t b = text.find(':', a + 1);
+        if (b == std::string::npos) {
+            throw std::invalid_argument("Range must be value or start:stop:step: " + text);
+        }
+        try {
+            return SweepRange(std::stod(text.substr(0, a)),
+                              std::stod(text.substr(a + 1, b - a - 1)),
+                              std::stod(text.substr(b + 1)));
+        } catch (const std::invalid_argument& e) {
+            throw std::invalid_argument(std::string(e.what()) + ": " + text);
+        }
+    }
+};
+
+/**
+ * @brief Grid coordinates: one value index per SweepSpec axis
+ */
+using SweepPoint = std::array<std::size_t, 6>;
+
+/**
+ * @brief Parameter ranges; defaults reproduce the original fixed values
+ * 
+ * Axis order (outermost first): gap, slow EMA, stop loss, take profit,
+ * max trades, market close minute.
+ */
+struct SweepSpec {
+    static constexpr std::size_t AXES = 6;
+    using Axes = std::array<std::vector<double>, AXES>;
+    
+    SweepRange gap_threshold{0.03};
+    SweepRange ema_slow_period{5};
+    SweepRange stop_loss_pct{0.02};
+    SweepRange take_profit_pct{0.07};
+    SweepRange max_daily_trades{2};
+    SweepRange market_close_minute{15 * 60};
+    int ema_fast_period = 3;              // Display-only, not swept
+    
+    Axes axes() const {
+        return {gap_threshold.values(), ema_slow_period.values(), stop_loss_pct.values(),
+                take_profit_pct.values(), max_daily_trades.values(),
+                market_close_minute.values()};
+    }
+    
+    static std::size_t gridSize(const Axes& axes) {
+        std::size_t size = 1;
+        for (const auto& axis : axes) size *= axis.size();
+        return size;
+    }
+    
+    BacktestConfig configAt(const Axes& axes, const SweepPoint& point) const {
+        BacktestConfig config;
+        config.strategy.gap_threshold = axes[0][point[0]];
+        config.strategy.ema_fast_period = ema_fast_period;
+        config.strategy.ema_slow_period = static_cast<int>(std::lround(axes[1][point[1]]));
+        config.risk.stop_loss_pct = axes[2][point[2]];
+        config.risk.take_profit_pct = axes[3][point[3]];
+        config.risk.max_daily_trades = static_cast<int>(std::lround(axes[4][point[4]]));
+        config.risk.market_close_minute = static_cast<int>(std::lround(axes[5][point[5]]));
+        return config;
+    }
+    
+    std::vector<BacktestConfig> expand() const {
+        const Axes grid_axes = axes();
+        std::vector<BacktestConfig> grid;
+        grid.reserve(gridSize(grid_axes));
+        
+        // Odometer over the axes, innermost axis fastest
+        SweepPoint point{};
+        while (true) {
+            grid.push_back(configAt(grid_axes, point));
+            std::size_t axis = AXES;
+            while (axis > 0 && ++point[axis - 1] == grid_axes[axis - 1].size()) {
+                point[--axis] = 0;
+            }
+            if (axis == 0) break;
+        }
+        return grid;
+    }
+};
+
+/**
+ * @brief Aggregate of runs over an ordered run of sessions
+ * 
+ * Mergeable: combining consecutive segments in order yields the same result
+ * as accumulating every session sequentially, including the drawdown of the
+ * cross-session equity curve (sum of session PnLs).
+ */
+struct SweepAccumulator {
+    double total_pnl = 0.0;
+    int sessions = 0;
+    int sessions_traded = 0;
+    int trades = 0;
+    int wins = 0;
+    int losses = 0;
+    double worst_session_pnl = std::numeric_limits<double>::infinity();
+    double best_session_pnl = -std::numeric_limits<double>::infinity();
+    double max_session_drawdown = 0.0;
+    
+    // Cross-session equity path, relative to the segment start
+    double equity_peak = 0.0;      // Max prefix sum (including 0)
+    double equity_trough = 0.0;    // Min prefix sum (including 0)
+    double equity_drawdown = 0.0;  // Max peak-to-trough within the segment
+    
+    void add(const RunSummary& run) {
+        SweepAccumulator single;
+        double pnl = run.pnl();
+        single.total_pnl = pnl;
+        single.sessions = 1;
+        single.sessions_traded = run.trades > 0;
+        single.trades = run.trades;
+        single.wins = run.wins;
+        single.losses = run.losses;
+        single.worst_session_pnl = pnl;
+        single.best_session_pnl = pnl;
+        single.max_session_drawdown = run.max_drawdown;
+        single.equity_peak = std::max(0.0, pnl);
+        single.equity_trough = std::min(0.0, pnl);
+        single.equity_drawdown = std::max(0.0, -pnl);
+        merge(single);
+    }
+    
+    /**
+     * @brief Append the segment `next` (which follows this one in session order)
+     */
+    void merge(const SweepAccumulator& next) {
+        equity_drawdown = std::max({equity_drawdown, next.equity_drawdown,
+                                    equity_peak - (total_pnl + next.equity_trough)});
+        equity_peak = std::max(equity_peak, total_pnl + next.equity_peak);
+        equity_trough = std::min(equity_trough, total_pnl + next.equity_trough);
+        
+        total_pnl += next.total_pnl;
+        sessions += next.sessions;
+        sessions_traded += next.sessions_traded;
+        trades += next.trades;
+        wins += next.wins;
+        losses += next.losses;
+        worst_session_pnl = std::min(worst_session_pnl, next.worst_session_pnl);
+        best_session_pnl = std::max(best_session_pnl, next.best_session_pnl);
+        max_session_drawdown = std::max(max_session_drawdown, next.max_session_drawdown);
+    }
+    
+    double winRate() const {
+        int closed = wins + losses;
+        return closed > 0 ? static_cast<double>(wins) / closed : 0.0;
+    }
+};
+
+/**
+ * @brief One row of the results table
+ */
+struct SweepResult {
+    BacktestConfig config;
+    SweepAccumulator stats;
+    MonteCarloSummary monte_carlo;  // paths == 0 unless requested
+};
+
+/**
+ * @class ParameterSweep
+ * @brief Parallel evaluator of configuration grids over a MarketUniverse
+ */
+class ParameterSweep {
+private:
+    const MarketUniverse& universe_;
+    IndicatorSeriesCache& cache_;
+    unsigned threads_;
+    std::size_t sessions_per_job_;
+    
+public:
+    ParameterSweep(const MarketUniverse& universe, IndicatorSeriesCache& cache,
+                   unsigned threads = 0, std::size_t sessions_per_job = 64)
+        : universe_(universe),
+          cache_(cache),
+          threads_(threads == 0 ? defaultThreadCount() : threads),
+          sessions_per_job_(std::max<std::size_t>(sessions_per_job, 1)) {}
+    
+    /**
+     * @brief EMA(period) series for every session, from the shared cache
+     * @param min_gap_threshold Sessions that cannot gap up even at this
+     *        threshold get a null entry instead of a series
+     * @return Per-session series, indexed [period slot][session]
+     */
+    std::vector<std::vector<SeriesPtr>> fetchEMASeries(const std::vector<int>& periods,
+                                                       double min_gap_threshold) const {
+        const std::size_t sessions = universe_.size();
+        std::vector<std::vector<SeriesPtr>> table(periods.size(),
+                                                  std::vector<SeriesPtr>(sessions));
+        parallelFor(periods.size() * sessions, threads_, [&](std::size_t job, unsigned) {
+            std::size_t p = job / sessions;
+            std::size_t s = job % sessions;
+            const MarketSession& session = universe_[s];
+            if (!session.index.canGapUp(min_gap_threshold)) return;
+            table[p][s] = cache_.getOrCompute(session.data, session.columns,
+                                              IndicatorType::EMA, periods[p]);
+        });
+        return table;
+    }
+    
+    /**
+     * @brief Signal candles for every (EMA period, gap threshold, session)
+     * @param series fetchEMASeries() output for `periods`
+     * @param gaps Distinct gap thresholds, ascending
+     * @return Signal lists indexed [(period slot * sessions + session) * gaps + gap slot]
+     * 
+     * Signals depend only on the strategy parameters, so they are found once
+     * here and shared by every risk / close setting. Thresholds go through
+     * GapLaneScanner LANES at a time: one candle pass per (period, session).
+     */
+    std::vector<std::vector<std::uint32_t>> scanSignals(
+        const std::vector<std::vector<SeriesPtr>>& series,
+        const std::vector<double>& gaps) const {
+        const std::size_t sessions = universe_.size();
+        const std::size_t g = gaps.size();
+        std::vector<std::vector<std::uint32_t>> signals(series.size() * sessions * g);
+        parallelFor(series.size() * sessions, threads_, [&](std::size_t job, unsigned) {
+            const MarketSession& session = universe_[job % sessions];
+            const auto& ema = series[job / sessions][job % sessions];
+            if (!ema) return;
+            
+            thread_local GapLaneScanner scanner;
+            for (std::size_t first = 0; first < g; first += GapLaneScanner::LANES) {
+                if (!session.index.canGapUp(gaps[first])) break;
+                const std::size_t lanes = std::min(GapLaneScanner::LANES, g - first);
+                scanner.scan(session.columns, ema->data(), session.data.previous_day_close,
+                             gaps.data() + first, lanes, &signals[job * g + first],
+                             session.index.scanStart(gaps[first]));
+            }
+        });
+        return signals;
+    }
+    
+    /**
+     * @brief Per-block partials for every configuration
+     * @param block_sessions Sessions per block; block b covers sessions
+     *        [b * block_sessions, (b + 1) * block_sessions)
+     * @param block_trades Optional sink for closed-trade P&Ls, indexed like the result
+     * @return Accumulators indexed [config * blocks + block]
+     * 
+     * Blocks are the unit of reuse: any run of consecutive blocks can be
+     * reduced with SweepAccumulator::merge without re-running a backtest.
+     */
+    std::vector<SweepAccumulator> accumulateBlocks(
+        const std::vector<BacktestConfig>& configs, std::size_t block_sessions,
+        std::vector<std::vector<double>>* block_trades = nullptr) const {
+        const std::size_t sessions = universe_.size();
+        block_sessions = std::max<std::size_t>(block_sessions, 1);
+        
+        // Distinct EMA periods → slot index
+        std::vector<int> periods;
+        for (const auto& config : configs) periods.push_back(config.strategy.ema_slow_period);
+        std::sort(periods.begin(), periods.end());
+        periods.erase(std::unique(periods.begin(), periods.end()), periods.end());
+        
+        double min_gap = std::numeric_limits<double>::infinity();
+        for (const auto& config : configs) {
+            min_gap = std::min(min_gap, config.strategy.gap_threshold);
+        }
+        
+        // Distinct gap thresholds → lane index
+        std::vector<double> gaps;
+        for (const auto& config : configs) gaps.push_back(config.strategy.gap_threshold);
+        std::sort(gaps.begin(), gaps.end());
+        gaps.erase(std::unique(gaps.begin(), gaps.end()), gaps.end());
+        
+        auto series = fetchEMASeries(periods, min_gap);
+        auto signals = scanSignals(series, gaps);
+        std::vector<std::size_t> slot(configs.size());
+        std::vector<std::size_t> gap_slot(configs.size());
+        for (std::size_t c = 0; c < configs.size(); ++c) {
+            slot[c] = static_cast<std::size_t>(
+                std::lower_bound(periods.begin(), periods.end(),
+                                 configs[c].strategy.ema_slow_period) - periods.begin());
+            gap_slot[c] = static_cast<std::size_t>(
+                std::lower_bound(gaps.begin(), gaps.end(),
+                                 configs[c].strategy.gap_threshold) - gaps.begin());
+        }
+        
+        const std::size_t blocks = (sessions + block_sessions - 1) / block_sessions;
+        std::vector<SweepAccumulator> partials(configs.size() * blocks);
+        if (block_trades) block_trades->assign(partials.size(), {});
+        
+        parallelFor(configs.size() * blocks, threads_, [&](std::size_t job, unsigned) {
+            const std::size_t c = job / blocks;
+            const std::size_t b = job % blocks;
+            const BacktestConfig& config = configs[c];
+            
+            SweepAccumulator& acc = partials[job];
+            std::vector<double>* trades = block_trades ? &(*block_trades)[job] : nullptr;
+            const std::size_t end = std::min(sessions, (b + 1) * block_sessions);
+            for (std::size_t s = b * block_sessions; s < end; ++s) {
+                const MarketSession& session = universe_[s];
+                const auto& session_signals =
+                    signals[(slot[c] * sessions + s) * gaps.size() + gap_slot[c]];
+                acc.add(runSignalBacktest(session.columns, session_signals,
+                                          session.data.capital, config, trades));
+            }
+        });
+        return partials;
+    }
+    
+    /**
+     * @brief Evaluate every configuration on every session
+     * @param monte_carlo If given, bootstrap each configuration's trade P&Ls
+     *        (in session order) starting from the first session's capital
+     * @return One result per configuration, in input order
+     */
+    std::vector<SweepResult> run(const std::vector<BacktestConfig>& configs,
+                                 const MonteCarloSpec* monte_carlo = nullptr) const {
+        const std::size_t sessions = universe_.size();
+        const std::size_t blocks = (sessions + sessions_per_job_ - 1) / sessions_per_job_;
+        std::vector<std::vector<double>> block_trades;
+        std::vector<SweepAccumulator> partials = accumulateBlocks(
+            configs, sessions_per_job_, monte_carlo ? &block_trades : nullptr);
+        
+        std::vector<SweepResult> results(configs.size());
+        for (std::size_t c = 0; c < configs.size(); ++c) {
+            results[c].config = configs[c];
+            for (std::size_t b = 0; b < blocks; ++b) {
+                results[c].stats.merge(partials[c * blocks + b]);
+            }
+        }
+        
+        if (monte_carlo && sessions > 0) {
+            // One configuration per job; paths inside a job stay on that thread
+            const double capital = universe_[0].data.capital;
+            const MonteCarloBootstrap bootstrap(*monte_carlo, 1);
+            parallelFor(configs.size(), threads_, [&](std::size_t c, unsigned) {
+                std::vector<double> pnls;
+                for (std::size_t b = 0; b < blocks; ++b) {
+                    const auto& trades = block_trades[c * blocks + b];
+                    pnls.insert(pnls.end(), trades.begin(), trades.end());
+                }
+                results[c].monte_carlo = bootstrap.summarize(pnls, capital);
+            });
+        }
+        return results;
+    }
+    
+    /**
+     * @brief Run one configuration on one session (series served from the cache)
+     */
+    RunSummary evaluate(const BacktestConfig& config, std::size_t session) const {
+        const MarketSession& market = universe_[session];
+        SeriesPtr ema;
+        if (market.index.canGapUp(config.strategy.gap_threshold)) {
+            ema = cache_.getOrCompute(market.data, market.columns, IndicatorType::EMA,
+                                      config.strategy.ema_slow_period);
+        }
+        return runSessionBacktest(market, ema ? ema->data() : nullptr, config);
+    }
+    
+    unsigned threadCount() const { return threads_; }
+};
+
+
+// ============================================================================
+// RESULTS TABLE
+// ============================================================================
+
+/**
+ * @brief Ranking objective: higher total PnL first (ties: smaller drawdown)
+ */
+inline bool isBetterResult(const SweepAccumulator& a, const SweepAccumulator& b) {
+    if (a.total_pnl != b.total_pnl) return a.total_pnl > b.total_pnl;
+    return a.equity_drawdown < b.equity_drawdown;
+}
+
+/**
+ * @brief Order results best-first by isBetterResult
+ */
+inline void sortSweepResults(std::vector<SweepResult>& results) {
+    std::stable_sort(results.begin(), results.end(),
+                     [](const SweepResult& a, const SweepResult& b) {
+        return isBetterResult(a.stats, b.stats);
+    });
+}
+
+inline void writeSweepResultsCSV(const std::string& filename,
+                                 const std::vector<SweepResult>& results) {
+    std::ofstream file(filename);
+    if (!file.is_open()) {
+        throw std::runtime_error("Cannot write file: " + filename);
+    }
+    
+    file << "gap_threshold,ema_slow_period,stop_loss_pct,take_profit_pct,"
+            "max_daily_trades,market_close_minute,total_pnl,sessions,sessions_traded,"
+            "trades,wins,losses,win_rate,worst_session_pnl,best_session_pnl,"
+            "max_session_drawdown,equity_drawdown";
+    const bool monte_carlo = !results.empty() && results.front().monte_carlo.paths > 0;
+    if (monte_carlo) {
+        file << ",mc_paths,mc_mean_final,mc_final_p5,mc_final_p50,mc_final_p95,"
+                "mc_drawdown_p50,mc_drawdown_p95,mc_ruin_probability";
+    }
+    file << '\n';
+    file << std::setprecision(10);
+    for (const auto& r : results) {
+        const auto& s = r.stats;
+        file << r.config.strategy.gap_threshold << ','
+             << r.config.strategy.ema_slow_period << ','
+             << r.config.risk.stop_loss_pct << ','
+             << r.config.risk.take_profit_pct << ','
+             << r.config.risk.max_daily_trades << ','
+             << r.config.risk.market_close_minute << ','
+             << s.total_pnl << ',' << s.sessions << ',' << s.sessions_traded << ','
+             << s.trades << ',' << s.wins << ',' << s.losses << ','
+             << s.winRate() << ','
+             << (s.sessions ? s.worst_session_pnl : 0.0) << ','
+             << (s.sessions ? s.best_session_pnl : 0.0) << ','
+             << s.max_session_drawdown << ',' << s.equity_drawdown;
+        if (monte_carlo) {
+            const auto& m = r.monte_carlo;
+            file << ',' << m.paths << ',' << m.mean_final_capital << ','
+                 << m.final_capital_p5 << ',' << m.final_capital_p50 << ','
+                 << m.final_capital_p95 << ',' << m.max_drawdown_p50 << ','
+                 << m.max_drawdown_p95 << ',' << m.ruin_probability;
+        }
+        file << '\n';
+    }
+}
+
+#endif // PARAMETER_SWEEP_HPP
@@ -0,0 +1,252 @@
+#ifndef PATTERN_BATCH_HPP
+#define PATTERN_BATCH_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <vector>
+#include "trading_engine.hpp"
+
+#if defined(__AVX2__) || defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
+/**
+ * @file pattern_batch.hpp
+ * @brief TwoCandelPatternStrategy for a whole universe, one timestamp at a time
+ * 
+ * A live universe advances every instrument on each 5-minute boundary.
+ * Per-object processCandle() calls branch on each instrument's state
+ * (first candle armed or not, breakdown or not), and across hundreds of
+ * instruments those branches are close to random. PatternBatch keeps the
+ * state of all instruments as columns and advances them together:
+ * 
+ *   ema      = ready ? close * α + ema * (1 - α) : close
+ *   arm      = !armed & (open >= gap_level) & (low > ema_slow)
+ *   fire     =  armed & (low < first_low)
+ *   first_low = arm ? low : first_low
+ *   armed    = (armed & !fire) | arm
+ * 
+ * Every select is a mask blend (AVX2: 4 instruments per op, SSE2: 2,
+ * scalar tail), so the cost per timestamp depends only on the universe
+ * size. The result is a bitmask with one bit per instrument.
+ * 
+ * MultiStrategyHost runs the same arm/fire step over its instances via
+ * stepWithEMA(), with the slow EMA taken from its shared registry.
+ * 
+ * Each instrument matches its own TwoCandelPatternStrategy (own EMAs,
+ * no shared registry) fed the same candles, bit for bit.
+ */
+
+/**
+ * @class PatternBatch
+ * @brief SoA two-candle state machines for N instruments
+ */
+class PatternBatch {
+private:
+    std::size_t n_;
+    
+    // Parameters
+    std::vector<double> gap_factor_;       // 1 + gap_threshold
+    std::vector<double> alpha_fast_;
+    std::vector<double> alpha_slow_;
+    std::vector<double> decay_fast_;       // 1 - alpha (EMACalculator's form)
+    std::vector<double> decay_slow_;
+    
+    // State; masks are all-ones / all-zero lanes
+    std::vector<double> gap_level_;        // previous_day_close * (1 + gap_threshold)
+    std::vector<double> ema_fast_;
+    std::vector<double> ema_slow_;
+    std::vector<double> first_low_;
+    std::vector<std::uint64_t> ready_;
+    std::vector<std::uint64_t> armed_;
+    
+    std::vector<std::uint64_t> signals_;   // bit i: instrument i signalled this step
+    
+#if !defined(__AVX2__) && defined(__SSE2__)
+    static __m128d blend(__m128d a, __m128d b, __m128d mask) {
+        return _mm_or_pd(_mm_and_pd(mask, b), _mm_andnot_pd(mask, a));
+    }
+#endif
+    
+    /**
+     * @brief ema = ready ? close * α + ema * (1 - α) : close, for both EMAs
+     */
+    void updateEMAs(const double* close) {
+        std::size_t i = 0;
+#if defined(__AVX2__)
+        const __m256d ones = _mm256_castsi256_pd(_mm256_set1_epi64x(-1));
+        for (; i + 4 <= n_; i += 4) {
+            const __m256d vclose = _mm256_loadu_pd(close + i);
+            const __m256d ready = _mm256_castsi256_pd(
+                _mm256_loadu_si256(reinterpret_cast<const __m256i*>(ready_.data() + i)));
+            __m256d fast = _mm256_loadu_pd(ema_fast_.data() + i);
+            __m256d slow = _mm256_loadu_pd(ema_slow_.data() + i);
+            fast = _mm256_blendv_pd(vclose, _mm256_add_pd(
+                       _mm256_mul_pd(vclose, _mm256_loadu_pd(alpha_fast_.data() + i)),
+                       _mm256_mul_pd(fast, _mm256_loadu_pd(decay_fast_.data() + i))), ready);
+            slow = _mm256_blendv_pd(vclose, _mm256_add_pd(
+                       _mm256_mul_pd(vclose, _mm256_loadu_pd(alpha_slow_.data() + i)),
+                       _mm256_mul_pd(slow, _mm256_loadu_pd(decay_slow_.data() + i))), ready);
+            _mm256_storeu_pd(ema_fast_.data() + i, fast);
+            _mm256_storeu_pd(ema_slow_.data() + i, slow);
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(ready_.data() + i),
+                                _mm256_castpd_si256(ones));
+        }
+#elif defined(__SSE2__)
+        const __m128d ones = _mm_castsi128_pd(_mm_set1_epi32(-1));
+        for (; i + 2 <= n_; i += 2) {
+            const __m128d vclose = _mm_loadu_pd(close + i);
+            const __m128d ready = _mm_castsi128_pd(
+                _mm_loadu_si128(reinterpret_cast<const __m128i*>(ready_.data() + i)));
+            __m128d fast = _mm_loadu_pd(ema_fast_.data() + i);
+            __m128d slow = _mm_loadu_pd(ema_slow_.data() + i);
+            fast = blend(vclose, _mm_add_pd(
+                       _mm_mul_pd(vclose, _mm_loadu_pd(alpha_fast_.data() + i)),
+                       _mm_mul_pd(fast, _mm_loadu_pd(decay_fast_.data() + i))), ready);
+            slow = blend(vclose, _mm_add_pd(
+                       _mm_mul_pd(vclose, _mm_loadu_pd(alpha_slow_.data() + i)),
+                       _mm_mul_pd(slow, _mm_loadu_pd(decay_slow_.data() + i))), ready);
+            _mm_storeu_pd(ema_fast_.data() + i, fast);
+            _mm_storeu_pd(ema_slow_.data() + i, slow);
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(ready_.data() + i), _mm_castpd_si128(ones));
+        }
+#endif
+        for (; i < n_; ++i) {
+            const bool ready = ready_[i] != 0;
+            ema_fast_[i] = ready ? (close[i] * alpha_fast_[i]) + (ema_fast_[i] * decay_fast_[i]) : close[i];
+            ema_slow_[i] = ready ? (close[i] * alpha_slow_[i]) + (ema_slow_[i] * decay_slow_[i]) : close[i];
+            ready_[i] = ~std::uint64_t(0);
+        }
+    }
+    
+    /**
+     * @brief arm/fire/first_low/armed update; fills signals_
+     */
+    const std::uint64_t* advancePattern(const double* open, const double* low, const double* slow) {
+        std::fill(signals_.begin(), signals_.end(), 0);
+        std::size_t i = 0;
+#if defined(__AVX2__)
+        for (; i + 4 <= n_; i += 4) {
+            const __m256d vlow = _mm256_loadu_pd(low + i);
+            __m256d armed = _mm256_castsi256_pd(
+                _mm256_loadu_si256(reinterpret_cast<const __m256i*>(armed_.data() + i)));
+            const __m256d first_low = _mm256_loadu_pd(first_low_.data() + i);
+            const __m256d gap_ok = _mm256_cmp_pd(_mm256_loadu_pd(open + i),
+                                                 _mm256_loadu_pd(gap_level_.data() + i), _CMP_GE_OQ);
+            const __m256d ema_ok = _mm256_cmp_pd(vlow, _mm256_loadu_pd(slow + i), _CMP_GT_OQ);
+            const __m256d arm = _mm256_andnot_pd(armed, _mm256_and_pd(gap_ok, ema_ok));
+            const __m256d fire = _mm256_and_pd(armed, _mm256_cmp_pd(vlow, first_low, _CMP_LT_OQ));
+            armed = _mm256_or_pd(_mm256_andnot_pd(fire, armed), arm);
+            _mm256_storeu_pd(first_low_.data() + i, _mm256_blendv_pd(first_low, vlow, arm));
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(armed_.data() + i),
+                                _mm256_castpd_si256(armed));
+            signals_[i / 64] |= static_cast<std::uint64_t>(_mm256_movemask_pd(fire)) << (i % 64);
+        }
+#elif defined(__SSE2__)
+        for (; i + 2 <= n_; i += 2) {
+            const __m128d vlow = _mm_loadu_pd(low + i);
+            __m128d armed = _mm_castsi128_pd(
+                _mm_loadu_si128(reinterpret_cast<const __m128i*>(armed_.data() + i)));
+            const __m128d first_low = _mm_loadu_pd(first_low_.data() + i);
+            const __m128d gap_ok = _mm_cmpge_pd(_mm_loadu_pd(open + i),
+                                                _mm_loadu_pd(gap_level_.data() + i));
+            const __m128d ema_ok = _mm_cmpgt_pd(vlow, _mm_loadu_pd(slow + i));
+            const __m128d arm = _mm_andnot_pd(armed, _mm_and_pd(gap_ok, ema_ok));
+            const __m128d fire = _mm_and_pd(armed, _mm_cmplt_pd(vlow, first_low));
+            armed = _mm_or_pd(_mm_andnot_pd(fire, armed), arm);
+            _mm_storeu_pd(first_low_.data() + i, blend(first_low, vlow, arm));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(armed_.data() + i), _mm_castpd_si128(armed));
+            signals_[i / 64] |= static_cast<std::uint64_t>(_mm_movemask_pd(fire)) << (i % 64);
+        }
+#endif
+        for (; i < n_; ++i) {
+            const bool armed = armed_[i] != 0;
+            const bool arm = !armed & (open[i] >= gap_level_[i]) & (low[i] > slow[i]);
+            const bool fire = armed & (low[i] < first_low_[i]);
+            first_low_[i] = arm ? low[i] : first_low_[i];
+            armed_[i] = ((armed & !fire) | arm) ? ~std::uint64_t(0) : 0;
+            signals_[i / 64] |= static_cast<std::uint64_t>(fire) << (i % 64);
+        }
+        return signals_.data();
+    }
+    
+public:
+    /**
+     * @param params One parameter set per instrument
+     */
+    explicit PatternBatch(const std::vector<StrategyParams>& params)
+        : n_(params.size()),
+          gap_factor_(n_), alpha_fast_(n_), alpha_slow_(n_), decay_fast_(n_), decay_slow_(n_),
+          gap_level_(n_), ema_fast_(n_), ema_slow_(n_), first_low_(n_),
+          ready_(n_), armed_(n_),
+          signals_((n_ + 63) / 64) {
+        for (std::size_t i = 0; i < n_; ++i) {
+            if (params[i].ema_fast_period <= 0 || params[i].ema_slow_period <= 0) {
+                throw std::invalid_argument("EMA periods must be positive");
+            }
+            gap_factor_[i] = 1.0 + params[i].gap_threshold;
+            alpha_fast_[i] = 2.0 / (params[i].ema_fast_period + 1.0);
+            alpha_slow_[i] = 2.0 / (params[i].ema_slow_period + 1.0);
+            decay_fast_[i] = 1.0 - alpha_fast_[i];
+            decay_slow_[i] = 1.0 - alpha_slow_[i];
+            beginSession(i, 0.0);
+        }
+    }
+    
+    PatternBatch(std::size_t instruments, const StrategyParams& params)
+        : PatternBatch(std::vector<StrategyParams>(instruments, params)) {}
+    
+    /**
+     * @brief Reset instrument i for a new session (TwoCandelPatternStrategy::initialize)
+     */
+    void beginSession(std::size_t i, double previous_day_close) {
+        gap_level_[i] = previous_day_close * gap_factor_[i];
+        ema_fast_[i] = 0.0;
+        ema_slow_[i] = 0.0;
+        first_low_[i] = 0.0;
+        ready_[i] = 0;
+        armed_[i] = 0;
+    }
+    
+    /**
+     * @brief Reset every instrument; previous_day_close has size() values
+     */
+    void beginSession(const double* previous_day_close) {
+        for (std::size_t i = 0; i < n_; ++i) beginSession(i, previous_day_close[i]);
+    }
+    
+    /**
+     * @brief Advance every instrument by one candle
+     * @param open, low, close One value per instrument (size() each)
+     * @return Signal bitmask, (size() + 63) / 64 words; bit i set if
+     *         instrument i's processCandle() would return true
+     */
+    const std::uint64_t* step(const double* open, const double* low, const double* close) {
+        updateEMAs(close);
+        return advancePattern(open, low, ema_slow_.data());
+    }
+    
+    /**
+     * @brief Advance the arm/fire rule against a slow EMA supplied by the caller
+     * 
+     * For hosts that compute EMAs elsewhere (e.g. one shared
+     * IndicatorRegistry); the batch's own EMAs are left untouched.
+     */
+    const std::uint64_t* stepWithEMA(const double* open, const double* low, const double* ema_slow) {
+        return advancePattern(open, low, ema_slow);
+    }
+    
+    bool signal(std::size_t i) const { return (signals_[i / 64] >> (i % 64)) & 1; }
+    const std::vector<std::uint64_t>& signalMask() const { return signals_; }
+    
+    double emaFast(std::size_t i) const { return ema_fast_[i]; }
+    double emaSlow(std::size_t i) const { return ema_slow_[i]; }
+    bool isArmed(std::size_t i) const { return armed_[i] != 0; }
+    double firstCandleLow(std::size_t i) const { return first_low_[i]; }
+    
+    std::size_t size() const { return n_; }
+};
+
+#endif // PATTERN_BATCH_HPP
@@ -0,0 +1,241 @@
+#ifndef PORTFOLIO_RISK_HPP
+#define PORTFOLIO_RISK_HPP
+
+#include <atomic>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include "trading_engine.hpp"
+
+/**
+ * @file portfolio_risk.hpp
+ * @brief Firm-wide limits shared by engines running on many threads
+ * 
+ * RiskManager limits one engine. PortfolioRisk holds the limits across
+ * all of them: gross exposure, daily loss and trade count. Every engine
+ * thread checks and updates it without a lock.
+ * 
+ * RESERVATIONS:
+ * An order reserves its notional, its worst-case loss (the stop-loss
+ * amount) and one trade before it is sent. Each reservation is a
+ * compare-and-swap that only succeeds if the counter stays within its
+ * limit, so the limits hold under any interleaving, including a gap-up
+ * morning where every engine signals on the same candle. A failed step
+ * rolls back the earlier ones. Closing the position releases the notional
+ * and turns the reserved loss into the realized P&L.
+ * 
+ * Amounts are kept as integer hundredths of a currency unit so that
+ * release exactly undoes reserve. Each counter sits on its own cache line,
+ * so threads that hit different counters do not share a line.
+ * 
+ * The daily loss limit bounds reserved stops plus realized losses. A fill
+ * that slips past its stop can still push the realized loss over the
+ * limit; after that, new orders are rejected.
+ */
+
+struct PortfolioLimits {
+    double max_gross_exposure = std::numeric_limits<double>::infinity();  // Sum of open notionals
+    double max_daily_loss = std::numeric_limits<double>::infinity();      // Reserved stops - realized P&L
+    int max_trades = std::numeric_limits<int>::max();                     // Orders per day
+};
+
+/**
+ * @brief Amounts held by one order between reserve() and release()
+ */
+struct PortfolioTicket {
+    std::int64_t notional = 0;
+    std::int64_t loss = 0;
+    bool active = false;
+};
+
+/**
+ * @class PortfolioRisk
+ * @brief Lock-free firm-wide limit book
+ */
+class PortfolioRisk {
+public:
+    static constexpr double UNITS_PER_CURRENCY = 100.0;
+    
+    enum class Rejection { NONE, TRADE_COUNT, GROSS_EXPOSURE, DAILY_LOSS };
+    
+    struct Snapshot {
+        double gross_exposure;
+        double loss_in_use;       // Reserved stops - realized P&L
+        double realized_pnl;
+        std::int64_t trades;
+        std::uint64_t rejected_trades;
+        std::uint64_t rejected_exposure;
+        std::uint64_t rejected_loss;
+    };
+    
+private:
+    struct alignas(64) PaddedCounter {
+        std::atomic<std::int64_t> value{0};
+    };
+    
+    std::int64_t max_exposure_;
+    std::int64_t max_loss_;
+    std::int64_t max_trades_;
+    
+    PaddedCounter exposure_;
+    PaddedCounter loss_;
+    PaddedCounter realized_;
+    PaddedCounter trades_;
+    
+    // Written only on rejection
+    alignas(64) std::atomic<std::uint64_t> rejected_trades_{0};
+    std::atomic<std::uint64_t> rejected_exposure_{0};
+    std::atomic<std::uint64_t> rejected_loss_{0};
+    
+    static std::int64_t toLimit(double amount) {
+        if (!(amount < 9e16 / UNITS_PER_CURRENCY)) return std::numeric_limits<std::int64_t>::max();
+        return static_cast<std::int64_t>(std::floor(amount * UNITS_PER_CURRENCY));
+    }
+    
+    /**
+     * @brief Add `amount` unless the counter would exceed `limit`
+     */
+    static bool tryAdd(std::atomic<std::int64_t>& counter, std::int64_t amount,
+                       std::int64_t limit) {
+        std::int64_t current = counter.load(std::memory_order_relaxed);
+        do {
+            if (current > limit - amount) return false;
+        } while (!counter.compare_exchange_weak(current, current + amount,
+                                                std::memory_order_acq_rel,
+                                                std::memory_order_relaxed));
+        return true;
+    }
+    
+public:
+    explicit PortfolioRisk(const PortfolioLimits& limits = PortfolioLimits())
+        : max_exposure_(toLimit(limits.max_gross_exposure)),
+          max_loss_(toLimit(limits.max_daily_loss)),
+          max_trades_(limits.max_trades) {}
+    
+    PortfolioRisk(const PortfolioRisk&) = delete;
+    PortfolioRisk& operator=(const PortfolioRisk&) = delete;
+    
+    /**
+     * @brief Amount in counter units, rounded up (reservations stay conservative)
+     */
+    static std::int64_t toUnits(double amount) {
+        return static_cast<std::int64_t>(std::ceil(amount * UNITS_PER_CURRENCY));
+    }
+    
+    /**
+     * @brief Reserve one order against every firm-wide limit
+     * @param notional Order value (price × quantity)
+     * @param max_loss Loss at which the order's stop closes it
+     * @param ticket Output: what to release when the position closes
+     */
+    Rejection reserve(double notional, double max_loss, PortfolioTicket& ticket) {
+        ticket = PortfolioTicket{toUnits(std::abs(notional)), toUnits(std::max(max_loss, 0.0)), false};
+        
+        if (!tryAdd(trades_.value, 1, max_trades_)) {
+            rejected_trades_.fetch_add(1, std::memory_order_relaxed);
+            return Rejection::TRADE_COUNT;
+        }
+        if (!tryAdd(exposure_.value, ticket.notional, max_exposure_)) {
+            trades_.value.fetch_sub(1, std::memory_order_relaxed);
+            rejected_exposure_.fetch_add(1, std::memory_order_relaxed);
+            return Rejection::GROSS_EXPOSURE;
+        }
+        if (!tryAdd(loss_.value, ticket.loss, max_loss_)) {
+            exposure_.value.fetch_sub(ticket.notional, std::memory_order_relaxed);
+            trades_.value.fetch_sub(1, std::memory_order_relaxed);
+            rejected_loss_.fetch_add(1, std::memory_order_relaxed);
+            return Rejection::DAILY_LOSS;
+        }
+        ticket.active = true;
+        return Rejection::NONE;
+    }
+    
+    /**
+     * @brief Position closed: free its notional, replace its stop with the realized P&L
+     */
+    void release(PortfolioTicket& ticket, double realized_pnl) {
+        if (!ticket.active) return;
+        const std::int64_t pnl = static_cast<std::int64_t>(std::llround(realized_pnl * UNITS_PER_CURRENCY));
+        exposure_.value.fetch_sub(ticket.notional, std::memory_order_acq_rel);
+        loss_.value.fetch_sub(ticket.loss + pnl, std::memory_order_acq_rel);
+        realized_.value.fetch_add(pnl, std::memory_order_relaxed);
+        ticket.active = false;
+    }
+    
+    /**
+     * @brief Cheap pre-check for callers that want to skip sizing (may race; reserve() decides)
+     */
+    bool canTrade() const {
+        return trades_.value.load(std::memory_order_relaxed) < max_trades_ &&
+               loss_.value.load(std::memory_order_relaxed) < max_loss_;
+    }
+    
+    Snapshot snapshot() const {
+        return Snapshot{exposure_.value.load() / UNITS_PER_CURRENCY,
+                        loss_.value.load() / UNITS_PER_CURRENCY,
+                        realized_.value.load() / UNITS_PER_CURRENCY,
+                        trades_.value.load(),
+                        rejected_trades_.load(), rejected_exposure_.load(), rejected_loss_.load()};
+    }
+    
+    /**
+     * @brief Start a new trading day; call with no engine running
+     */
+    void resetDay() {
+        exposure_.value.store(0);
+        loss_.value.store(0);
+        realized_.value.store(0);
+        trades_.value.store(0);
+        rejected_trades_.store(0);
+        rejected_exposure_.store(0);
+        rejected_loss_.store(0);
+    }
+};
+
+// ============================================================================
+// ENGINE RISK MODEL
+// ============================================================================
+
+/**
+ * @class PortfolioRiskManager
+ * @brief RiskManager that also reserves each order in a shared PortfolioRisk
+ * 
+ * Use as the Risk argument of TradingEngine. canTrade() is the engine's
+ * own daily limit only; firm-wide limits are enforced by reserveOrder(),
+ * which the engine calls after sizing (see has_order_reservation), so a
+ * refused order is counted in PortfolioRisk's rejected_* counters and
+ * logged as a portfolio limit. Without a portfolio it behaves exactly
+ * like RiskManager. One engine per thread; the PortfolioRisk is shared.
+ * 
+ * Checkpoints carry the RiskManager state only; reservations belong to
+ * the running process.
+ */
+class PortfolioRiskManager : public RiskManager {
+private:
+    PortfolioRisk* portfolio_;
+    PortfolioTicket ticket_;
+    PortfolioRisk::Rejection last_rejection_ = PortfolioRisk::Rejection::NONE;
+    
+public:
+    explicit PortfolioRiskManager(double capital, const RiskParams& params = RiskParams(),
+                                  PortfolioRisk* portfolio = nullptr)
+        : RiskManager(capital, params), portfolio_(portfolio) {}
+    
+    /**
+     * @return False if a firm-wide limit refuses the order (nothing held)
+     */
+    bool reserveOrder(double entry_price, int quantity) {
+        if (!portfolio_) return true;
+        last_rejection_ = portfolio_->reserve(entry_price * quantity, getStopLossAmount(), ticket_);
+        return last_rejection_ == PortfolioRisk::Rejection::NONE;
+    }
+    
+    void updateCapital(double pnl) {
+        RiskManager::updateCapital(pnl);
+        if (portfolio_) portfolio_->release(ticket_, pnl);
+    }
+    
+    PortfolioRisk::Rejection getLastRejection() const { return last_rejection_; }
+};
+
+#endif // PORTFOLIO_RISK_HPP
@@ -0,0 +1,261 @@
+#ifndef PRE_TRADE_HPP
+#define PRE_TRADE_HPP
+
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <thread>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+/**
+ * @file pre_trade.hpp
+ * @brief Table-driven pre-trade risk checks with latency accounting
+ * 
+ * Every check on an order compares one field of the order against a limit:
+ * 
+ *   field             rule                          example
+ *   TRADING_ALLOWED   >= 1                          daily trade limit not reached
+ *   OPEN_POSITIONS    <= 0                          no pyramiding
+ *   QUANTITY          >= 1 / <= max                 sizing produced shares / fat finger
+ *   NOTIONAL          <= max                        price × quantity
+ *   PRICE_DEVIATION   <= band                       |price / reference - 1|
+ * 
+ * so the checks are rows of a flat table (24 bytes per rule, in the
+ * engine object) instead of a chain of if statements. check()
+ * evaluates every row without branching on the outcome, collects the
+ * failures in a bitmask and rejects on the first failing row in table
+ * order. Adding a rule costs one compare, not a new branch in the order
+ * path.
+ * 
+ * Each check() is timed with the CPU timestamp counter (rdtsc; a
+ * steady_clock fallback elsewhere) into a power-of-two histogram, and
+ * each rule counts its rejections.
+ */
+
+// ============================================================================
+// CYCLE COUNTER
+// ============================================================================
+
+/**
+ * @brief Current value of the CPU timestamp counter
+ */
+inline std::uint64_t readCycleCounter() {
+#if defined(__x86_64__) || defined(__i386__)
+    return __rdtsc();
+#else
+    return static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+#endif
+}
+
+/**
+ * @brief Counter ticks per nanosecond, measured once against steady_clock
+ * 
+ * The first call sleeps for about 20 ms.
+ */
+inline double cycleCounterTicksPerNanosecond() {
+    static const double ticks_per_ns = [] {
+        const auto wall_start = std::chrono::steady_clock::now();
+        const std::uint64_t start = readCycleCounter();
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        const std::uint64_t end = readCycleCounter();
+        const double ns = static_cast<double>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now() - wall_start).count());
+        return ns > 0 ? static_cast<double>(end - start) / ns : 1.0;
+    }();
+    return ticks_per_ns;
+}
+
+/**
+ * @class LatencyHistogram
+ * @brief Counts of durations in power-of-two buckets of counter ticks
+ * 
+ * Bucket b holds durations in [2^(b-1), 2^b) ticks (bucket 0: zero).
+ * Recording is a bit scan and an increment.
+ */
+class LatencyHistogram {
+public:
+    static constexpr std::size_t BUCKETS = 65;
+    
+private:
+    std::array<std::uint64_t, BUCKETS> counts_{};
+    std::uint64_t total_ = 0;
+    std::uint64_t max_ticks_ = 0;
+    
+public:
+    void record(std::uint64_t ticks) {
+        const std::size_t bucket = ticks ? 64 - static_cast<std::size_t>(__builtin_clzll(ticks)) : 0;
+        ++counts_[bucket];
+        ++total_;
+        max_ticks_ = ticks > max_ticks_ ? ticks : max_ticks_;
+    }
+    
+    /**
+     * @brief Upper bound in ticks of the q-quantile (0 < q <= 1)
+     */
+    std::uint64_t percentileTicks(double q) const {
+        if (total_ == 0) return 0;
+        const std::uint64_t rank = static_cast<std::uint64_t>(std::ceil(q * static_cast<double>(total_)));
+        std::uint64_t seen = 0;
+        for (std::size_t b = 0; b < BUCKETS; ++b) {
+            seen += counts_[b];
+            if (seen >= rank) return b == 0 ? 0 : (b == 64 ? max_ticks_ : (std::uint64_t(1) << b) - 1);
+        }
+        return max_ticks_;
+    }
+    
+    double percentileNanoseconds(double q) const {
+        return static_cast<double>(percentileTicks(q)) / cycleCounterTicksPerNanosecond();
+    }
+    
+    std::uint64_t bucketCount(std::size_t bucket) const { return counts_[bucket]; }
+    std::uint64_t count() const { return total_; }
+    std::uint64_t maxTicks() const { return max_ticks_; }
+    
+    void reset() {
+        counts_.fill(0);
+        total_ = 0;
+        max_ticks_ = 0;
+    }
+};
+
+// ============================================================================
+// RULE TABLE
+// ============================================================================
+
+enum class PreTradeField : std::uint8_t {
+    TRADING_ALLOWED,    // 1 if the risk model allows another trade today
+    OPEN_POSITIONS,
+    QUANTITY,
+    NOTIONAL,
+    PRICE_DEVIATION,    // |price / reference_price - 1|; 0 without a reference
+    COUNT
+};
+
+enum class PreTradeBound : std::uint8_t { MIN, MAX };
+
+/**
+ * @brief One check: the order passes if field >= limit (MIN) or <= limit (MAX)
+ */
+struct PreTradeRule {
+    PreTradeField field;
+    PreTradeBound bound;
+    double limit;
+    const char* reject_message;     // Logged when this rule rejects
+};
+
+/**
+ * @brief Order as the pre-trade stage sees it
+ */
+struct PreTradeOrder {
+    double price;
+    int quantity;
+    double reference_price;         // e.g. previous day close, for price bands
+    bool trading_allowed;
+    bool position_open;
+};
+
+/**
+ * @class PreTradePipeline
+ * @brief Fixed-order rule table with rejection counters and latency histogram
+ * 
+ * Not thread-safe; each engine owns one.
+ */
+class PreTradePipeline {
+public:
+    static constexpr std::size_t MAX_RULES = 32;     // One bit each in the failure mask
+    
+private:
+    std::array<PreTradeRule, MAX_RULES> rules_{};
+    std::array<std::uint64_t, MAX_RULES> rejections_{};
+    std::size_t size_ = 0;
+    std::uint64_t checked_ = 0;
+    LatencyHistogram latency_;
+    
+public:
+    PreTradePipeline() = default;
+    
+    /**
+     * @brief Checks TradingEngine has always made, in the same order
+     */
+    static PreTradePipeline withDefaultRules() {
+        PreTradePipeline pipeline;
+        pipeline.addRule({PreTradeField::TRADING_ALLOWED, PreTradeBound::MIN, 1.0,
+                          "Trade limit reached for the day"});
+        pipeline.addRule({PreTradeField::OPEN_POSITIONS, PreTradeBound::MAX, 0.0,
+                          "Position already open - skipping signal"});
+        pipeline.addRule({PreTradeField::QUANTITY, PreTradeBound::MIN, 1.0,
+                          "Insufficient capital for position"});
+        return pipeline;
+    }
+    
+    /**
+     * @brief Append a rule; it runs after every rule already in the table
+     */
+    void addRule(const PreTradeRule& rule) {
+        if (size_ == MAX_RULES) {
+            throw std::length_error("Pre-trade rule table is full");
+        }
+        if (rule.field >= PreTradeField::COUNT) {
+            throw std::invalid_argument("Unknown pre-trade field");
+        }
+        rules_[size_++] = rule;
+    }
+    
+    /**
+     * @brief Evaluate every rule against the order
+     * @return The first failing rule in table order, or nullptr to accept
+     */
+    const PreTradeRule* check(const PreTradeOrder& order) {
+        const std::uint64_t start = readCycleCounter();
+        
+        const double fields[static_cast<std::size_t>(PreTradeField::COUNT)] = {
+            order.trading_allowed ? 1.0 : 0.0,
+            order.position_open ? 1.0 : 0.0,
+            static_cast<double>(order.quantity),
+            order.price * order.quantity,
+            order.reference_price > 0 ? std::abs(order.price / order.reference_price - 1.0) : 0.0
+        };
+        std::uint32_t failed = 0;
+        for (std::size_t i = 0; i < size_; ++i) {
+            const PreTradeRule& rule = rules_[i];
+            const double value = fields[static_cast<std::size_t>(rule.field)];
+            const bool fail = rule.bound == PreTradeBound::MIN ? value < rule.limit
+                                                               : value > rule.limit;
+            failed |= static_cast<std::uint32_t>(fail) << i;
+        }
+        
+        const PreTradeRule* rejected = nullptr;
+        if (failed) {
+            const std::size_t first = static_cast<std::size_t>(__builtin_ctz(failed));
+            ++rejections_[first];
+            rejected = &rules_[first];
+        }
+        ++checked_;
+        latency_.record(readCycleCounter() - start);
+        return rejected;
+    }
+    
+    std::size_t size() const { return size_; }
+    const PreTradeRule& rule(std::size_t i) const { return rules_[i]; }
+    std::uint64_t rejections(std::size_t i) const { return rejections_[i]; }
+    std::uint64_t checked() const { return checked_; }
+    const LatencyHistogram& latency() const { return latency_; }
+    
+    /**
+     * @brief Clear counters and histogram; rules stay
+     */
+    void resetStats() {
+        rejections_.fill(0);
+        checked_ = 0;
+        latency_.reset();
+    }
+};
+
+#endif // PRE_TRADE_HPP
@@ -0,0 +1,199 @@
+#ifndef RESAMPLER_HPP
+#define RESAMPLER_HPP
+
+#include <algorithm>
+#include <functional>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+#include "candle_columns.hpp"
+#include "trading_engine.hpp"
+
+/**
+ * @file resampler.hpp
+ * @brief Streaming aggregation of base candles into higher timeframes
+ * 
+ * One pass over the 5-minute stream feeds every timeframe: each resampler
+ * folds the incoming candle into its open bar in O(1) and emits the bar as
+ * soon as its last constituent arrives. Bars are aligned to the session
+ * open (09:15 by default), so 15-minute bars are 09:15, 09:30, ... and
+ * hourly bars 09:15, 10:15, ..., matching exchange charting.
+ */
+
+constexpr int DEFAULT_SESSION_OPEN_MINUTE = 9 * 60 + 15;
+
+/**
+ * @class CandleResampler
+ * @brief Incremental OHLC aggregation into one higher timeframe
+ */
+class CandleResampler {
+private:
+    int timeframe_minutes_;
+    int base_minutes_;
+    int anchor_minute_;
+    
+    Candle bar_;
+    int bucket_;
+    bool bar_open_;
+    
+    int bucketOf(int minute_of_day) const {
+        int offset = minute_of_day - anchor_minute_;
+        // Floor division so pre-open candles land in negative buckets
+        return offset >= 0 ? offset / timeframe_minutes_
+                           : -((-offset + timeframe_minutes_ - 1) / timeframe_minutes_);
+    }
+    
+public:
+    CandleResampler(int timeframe_minutes, int base_minutes = 5,
+                    int anchor_minute = DEFAULT_SESSION_OPEN_MINUTE)
+        : timeframe_minutes_(timeframe_minutes),
+          base_minutes_(base_minutes),
+          anchor_minute_(anchor_minute),
+          bucket_(0),
+          bar_open_(false) {
+        if (base_minutes <= 0 || timeframe_minutes < base_minutes ||
+            timeframe_minutes % base_minutes != 0) {
+            throw std::invalid_argument(
+                "Timeframe must be a positive multiple of the base interval");
+        }
+    }
+    
+    /**
+     * @brief Fold a base candle into the current bar
+     * @param emit Called with each completed bar (at most twice per call:
+     *             a bar cut short by a data gap, then the current one)
+     */
+    template <typename Emit>
+    void update(const Candle& candle, Emit&& emit) {
+        const int minute = parseMinuteOfDay(candle.timestamp);
+        const int bucket = bucketOf(minute);
+        
+        // Missing constituents: close the stale bar before starting a new one
+        if (bar_open_ && bucket != bucket_) {
+            bar_open_ = false;
+            emit(static_cast<const Candle&>(bar_));
+        }
+        
+        if (!bar_open_) {
+            bar_ = candle;
+            bar_.timestamp = formatMinuteOfDay(anchor_minute_ + bucket * timeframe_minutes_);
+            bucket_ = bucket;
+            bar_open_ = true;
+        } else {
+            bar_.high = std::max(bar_.high, candle.high);
+            bar_.low = std::min(bar_.low, candle.low);
+            bar_.close = candle.close;
+            bar_.volume += candle.volume;
+        }
+        
+        // Last constituent: emit now rather than waiting for the next bar
+        const int bucket_end = anchor_minute_ + (bucket_ + 1) * timeframe_minutes_;
+        if (minute + base_minutes_ >= bucket_end) {
+            bar_open_ = false;
+            emit(static_cast<const Candle&>(bar_));
+        }
+    }
+    
+    /**
+     * @brief Emit the partial bar at end of data (if any)
+     */
+    template <typename Emit>
+    void flush(Emit&& emit) {
+        if (bar_open_) {
+            bar_open_ = false;
+            emit(static_cast<const Candle&>(bar_));
+        }
+    }
+    
+    bool hasOpenBar() const { return bar_open_; }
+    /// Bar in progress (valid while hasOpenBar())
+    const Candle& currentBar() const { return bar_; }
+    int getTimeframeMinutes() const { return timeframe_minutes_; }
+    
+    void reset() { bar_open_ = false; }
+};
+
+/**
+ * @class MultiTimeframeHub
+ * @brief Fan-out of one base candle stream to any number of timeframes
+ * 
+ * Subscribers (indicators, strategies) register per timeframe. Subscribing
+ * at the base interval receives the raw candles. Each timeframe has one
+ * resampler regardless of how many subscribers it has.
+ * 
+ * Example:
+ *   MultiTimeframeHub hub;
+ *   hub.subscribe(15, [&](const Candle& bar) { registry15.update(bar); });
+ *   hub.subscribe(60, [&](const Candle& bar) { hourly.processCandle(bar); });
+ *   for (const auto& candle : data.candles) hub.onCandle(candle);
+ *   hub.flush();
+ */
+class MultiTimeframeHub {
+public:
+    using Subscriber = std::function<void(const Candle&)>;
+    
+private:
+    struct Timeframe {
+        CandleResampler resampler;
+        std::vector<Subscriber> subscribers;
+        
+        explicit Timeframe(CandleResampler r) : resampler(std::move(r)) {}
+        
+        void publish(const Candle& bar) const {
+            for (const auto& subscriber : subscribers) subscriber(bar);
+        }
+    };
+    
+    int base_minutes_;
+    int anchor_minute_;
+    std::vector<Subscriber> base_subscribers_;
+    std::vector<Timeframe> timeframes_;
+    
+public:
+    explicit MultiTimeframeHub(int base_minutes = 5,
+                               int anchor_minute = DEFAULT_SESSION_OPEN_MINUTE)
+        : base_minutes_(base_minutes), anchor_minute_(anchor_minute) {}
+    
+    void subscribe(int timeframe_minutes, Subscriber subscriber) {
+        if (timeframe_minutes == base_minutes_) {
+            base_subscribers_.push_back(std::move(subscriber));
+            return;
+        }
+        
+        for (auto& tf : timeframes_) {
+            if (tf.resampler.getTimeframeMinutes() == timeframe_minutes) {
+                tf.subscribers.push_back(std::move(subscriber));
+                return;
+            }
+        }
+        
+        timeframes_.emplace_back(
+            CandleResampler(timeframe_minutes, base_minutes_, anchor_minute_));
+        timeframes_.back().subscribers.push_back(std::move(subscriber));
+    }
+    
+    /**
+     * @brief Feed one base candle; O(1) per subscribed timeframe
+     */
+    void onCandle(const Candle& candle) {
+        for (const auto& subscriber : base_subscribers_) subscriber(candle);
+        for (auto& tf : timeframes_) {
+            tf.resampler.update(candle, [&tf](const Candle& bar) { tf.publish(bar); });
+        }
+    }
+    
+    /**
+     * @brief Publish partial bars at end of session
+     */
+    void flush() {
+        for (auto& tf : timeframes_) {
+            tf.resampler.flush([&tf](const Candle& bar) { tf.publish(bar); });
+        }
+    }
+    
+    void reset() {
+        for (auto& tf : timeframes_) tf.resampler.reset();
+    }
+};
+
+#endif // RESAMPLER_HPP
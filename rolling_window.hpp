@@ -0,0 +1,186 @@
+#ifndef ROLLING_WINDOW_HPP
+#define ROLLING_WINDOW_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+/**
+ * @file rolling_window.hpp
+ * @brief Rolling-window min/max (lookback extremes) in amortised O(1)
+ * 
+ * Breakout and N-bar-low filters need the extreme of the last N values.
+ * A naive rescan costs O(N) per candle. A monotonic deque keeps only the
+ * values that can still become the extreme: each value is pushed once and
+ * popped at most once, so updates are amortised O(1) regardless of N.
+ * 
+ * LOOKBACK USAGE:
+ * getValue() before update(x) is the extreme of the previous N bars, which
+ * is what "low breaks the N-bar low" compares against. IndicatorRegistry
+ * feeds each value one candle late for exactly this reason.
+ */
+
+enum class Extreme { MIN, MAX };
+
+/**
+ * @class RollingExtreme
+ * @brief Incremental min or max over the last `window` values
+ * 
+ * The deque lives in a fixed ring of `window` slots (it can never hold
+ * more), so updates never allocate.
+ */
+class RollingExtreme {
+public:
+    struct Entry {
+        std::uint64_t index;
+        double value;
+    };
+    
+private:
+    Extreme kind_;
+    std::size_t window_;
+    std::vector<Entry> ring_;
+    std::size_t head_;        // Ring slot of the deque front
+    std::size_t size_;        // Deque length
+    std::uint64_t count_;     // Values seen so far
+    
+    // True if `a` makes `b` irrelevant as a future extreme
+    bool dominates(double a, double b) const {
+        return kind_ == Extreme::MIN ? a <= b : a >= b;
+    }
+    
+    std::size_t slot(std::size_t offset) const {
+        std::size_t s = head_ + offset;
+        return s >= window_ ? s - window_ : s;
+    }
+    
+public:
+    RollingExtreme(std::size_t window, Extreme kind)
+        : kind_(kind), window_(window), ring_(window),
+          head_(0), size_(0), count_(0) {
+        if (window == 0) {
+            throw std::invalid_argument("Rolling window must be positive");
+        }
+    }
+    
+    /**
+     * @brief Push a new value and expire the one leaving the window
+     */
+    void update(double value) {
+        // Drop values the new one dominates (from the back)
+        while (size_ > 0 && dominates(value, ring_[slot(size_ - 1)].value)) {
+            --size_;
+        }
+        
+        // Expire the front once it falls out of the window
+        if (size_ > 0 && ring_[head_].index + window_ <= count_) {
+            head_ = slot(1);
+            --size_;
+        }
+        
+        ring_[slot(size_)] = Entry{count_, value};
+        ++size_;
+        ++count_;
+    }
+    
+    /// Extreme over the last min(count, window) values
+    double getValue() const { return ring_[head_].value; }
+    bool isInitialized() const { return count_ > 0; }
+    /// True once a full window has been seen
+    bool isReady() const { return count_ >= window_; }
+    std::size_t getWindow() const { return window_; }
+    Extreme getKind() const { return kind_; }
+    
+    void reset() {
+        head_ = 0;
+        size_ = 0;
+        count_ = 0;
+    }
+    
+    /**
+     * @brief Snapshot: values seen plus the live deque, front to back
+     */
+    struct State {
+        std::uint64_t count;
+        std::vector<Entry> entries;
+    };
+    
+    State getState() const {
+        State state{count_, {}};
+        state.entries.reserve(size_);
+        for (std::size_t i = 0; i < size_; ++i) state.entries.push_back(ring_[slot(i)]);
+        return state;
+    }
+    
+    void restoreState(const State& state) {
+        if (state.entries.size() > window_) {
+            throw std::invalid_argument("Rolling window state exceeds window");
+        }
+        head_ = 0;
+        size_ = state.entries.size();
+        count_ = state.count;
+        for (std::size_t i = 0; i < size_; ++i) ring_[i] = state.entries[i];
+    }
+};
+
+
+// ============================================================================
+// BATCH MODE (SoA COLUMNS)
+// ============================================================================
+
+namespace detail {
+
+template <Extreme Kind>
+void computeRollingExtremeSeries(const double* values, double* out,
+                                 std::size_t n, std::size_t window) {
+    if (window == 0) {
+        throw std::invalid_argument("Rolling window must be positive");
+    }
+    
+    // Deque of indices into `values`; ring of window slots
+    std::vector<std::size_t> ring(window);
+    std::size_t head = 0;
+    std::size_t size = 0;
+    
+    for (std::size_t i = 0; i < n; ++i) {
+        const double x = values[i];
+        while (size > 0) {
+            std::size_t back = head + size - 1;
+            if (back >= window) back -= window;
+            const double y = values[ring[back]];
+            if (Kind == Extreme::MIN ? !(x <= y) : !(x >= y)) break;
+            --size;
+        }
+        if (size > 0 && ring[head] + window <= i) {
+            head = head + 1 == window ? 0 : head + 1;
+            --size;
+        }
+        std::size_t tail = head + size;
+        if (tail >= window) tail -= window;
+        ring[tail] = i;
+        ++size;
+        out[i] = values[ring[head]];
+    }
+}
+
+} // namespace detail
+
+/**
+ * @brief out[i] = min(values[i-window+1 .. i]), partial windows at the start
+ */
+inline void computeRollingMinSeries(const double* values, double* out,
+                                    std::size_t n, std::size_t window) {
+    detail::computeRollingExtremeSeries<Extreme::MIN>(values, out, n, window);
+}
+
+/**
+ * @brief out[i] = max(values[i-window+1 .. i]), partial windows at the start
+ */
+inline void computeRollingMaxSeries(const double* values, double* out,
+                                    std::size_t n, std::size_t window) {
+    detail::computeRollingExtremeSeries<Extreme::MAX>(values, out, n, window);
+}
+
+#endif // ROLLING_WINDOW_HPP
@@ -0,0 +1,852 @@
+#ifndef RULE_DSL_HPP
+#define RULE_DSL_HPP
+
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <ostream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include "candle_columns.hpp"
+#include "trading_engine.hpp"
+
+/**
+ * @file rule_dsl.hpp
+ * @brief Entry-rule expressions compiled to register bytecode
+ *
+ * Lets researchers change entry conditions without a rebuild:
+ *
+ *   open >= prev_close * 1.03 && low > ema(5)
+ *
+ * GRAMMAR (lowest precedence first):
+ *   expr    := and ('||' and)*
+ *   and     := equal ('&&' equal)*
+ *   equal   := compare (('==' | '!=') compare)*
+ *   compare := sum (('<' | '<=' | '>' | '>=') sum)*
+ *   sum     := product (('+' | '-') product)*
+ *   product := unary (('*' | '/') unary)*
+ *   unary   := ('!' | '-') unary | primary
+ *   primary := number | HH:MM | true | false | variable | call | '(' expr ')'
+ *
+ * VARIABLES: open high low close volume minute prev_close, plus
+ *   setup_open setup_high setup_low setup_close (RuleStrategy trigger only)
+ * FUNCTIONS: ema(n [, src]), lowest(n [, src]), highest(n [, src]),
+ *   abs(x), min(a, b), max(a, b); src is open/high/low/close
+ * lowest/highest cover the n candles before the current one, so
+ * "low < lowest(20)" is a new 20-bar low; rules using them hold off
+ * until n candles have been seen.
+ * Booleans are 1.0 / 0.0; any non-zero value is true. Both sides of
+ * && and || are always evaluated (no side effects, no branches).
+ *
+ * COMPILATION (once, at load time):
+ * 1. Tokenize and parse; constant subtrees are folded while parsing
+ * 2. Indicator calls become IndicatorRegistry requests (type, period, source)
+ * 3. Subtrees that only depend on constants and prev_close are hoisted into
+ *    a per-session prelude (prev_close * 1.03 is computed once per day)
+ * 4. Each remaining operator becomes one three-address instruction over a
+ *    flat register file: [fields][indicators][constants][temporaries].
+ *    Leaves cost nothing at run time; they are just register numbers.
+ *
+ * EVALUATION:
+ * Streaming: fill field/indicator registers, run a short switch loop.
+ * Batch: the same instructions over blocks of SoA columns, one tight
+ * (vectorisable) loop per instruction.
+ */
+
+enum class RuleField {
+    OPEN, HIGH, LOW, CLOSE, VOLUME, MINUTE, PREV_CLOSE,
+    SETUP_OPEN, SETUP_HIGH, SETUP_LOW, SETUP_CLOSE,
+    COUNT
+};
+
+enum class RuleOp : std::uint8_t {
+    ADD, SUB, MUL, DIV, NEG,
+    LT, LE, GT, GE, EQ, NE,
+    AND, OR, NOT,
+    ABS, MIN, MAX
+};
+
+struct RuleInstruction {
+    RuleOp op;
+    std::uint16_t dst;
+    std::uint16_t a;
+    std::uint16_t b;  // == a for unary operators
+};
+
+/**
+ * @brief Indicator referenced by a rule, resolved through IndicatorRegistry
+ */
+struct RuleIndicator {
+    IndicatorType type;
+    int period;
+    PriceSource source;
+    
+    bool operator==(const RuleIndicator& other) const {
+        return type == other.type && period == other.period && source == other.source;
+    }
+    
+    std::string name() const {
+        std::string base = type == IndicatorType::EMA ? "EMA"
+                         : type == IndicatorType::ROLLING_MIN ? "LOW" : "HIGH";
+        PriceSource natural = type == IndicatorType::ROLLING_MIN ? PriceSource::LOW
+                            : type == IndicatorType::ROLLING_MAX ? PriceSource::HIGH
+                            : PriceSource::CLOSE;
+        base += std::to_string(period);
+        if (source != natural) {
+            static const char* names[] = {"open", "high", "low", "close"};
+            base += std::string("(") + names[static_cast<int>(source)] + ")";
+        }
+        return base;
+    }
+};
+
+inline double applyRuleOp(RuleOp op, double x, double y) {
+    switch (op) {
+        case RuleOp::ADD: return x + y;
+        case RuleOp::SUB: return x - y;
+        case RuleOp::MUL: return x * y;
+        case RuleOp::DIV: return x / y;
+        case RuleOp::NEG: return -x;
+        case RuleOp::LT:  return x < y ? 1.0 : 0.0;
+        case RuleOp::LE:  return x <= y ? 1.0 : 0.0;
+        case RuleOp::GT:  return x > y ? 1.0 : 0.0;
+        case RuleOp::GE:  return x >= y ? 1.0 : 0.0;
+        case RuleOp::EQ:  return x == y ? 1.0 : 0.0;
+        case RuleOp::NE:  return x != y ? 1.0 : 0.0;
+        case RuleOp::AND: return (x != 0.0) & (y != 0.0) ? 1.0 : 0.0;
+        case RuleOp::OR:  return (x != 0.0) | (y != 0.0) ? 1.0 : 0.0;
+        case RuleOp::NOT: return x == 0.0 ? 1.0 : 0.0;
+        case RuleOp::ABS: return std::fabs(x);
+        case RuleOp::MIN: return std::min(x, y);
+        case RuleOp::MAX: return std::max(x, y);
+    }
+    return 0.0;
+}
+
+
+// ============================================================================
+// COMPILER
+// ============================================================================
+
+namespace rule_detail {
+
+struct Token {
+    enum Kind { NUMBER, IDENT, SYMBOL, END } kind;
+    std::string text;
+    double number;
+    std::size_t pos;
+};
+
+inline std::vector<Token> tokenize(const std::string& src) {
+    std::vector<Token> tokens;
+    std::size_t i = 0;
+    while (i < src.size()) {
+        char c = src[i];
+        if (std::isspace(static_cast<unsigned char>(c))) {
+            ++i;
+            continue;
+        }
+        const std::size_t start = i;
+        
+        if (std::isdigit(static_cast<unsigned char>(c)) || c == '.') {
+            // HH:MM time literal → minutes since midnight
+            std::size_t j = i;
+            while (j < src.size() && std::isdigit(static_cast<unsigned char>(src[j]))) ++j;
+            if (j > i && j - i <= 2 && j + 2 < src.size() && src[j] == ':' &&
+                std::isdigit(static_cast<unsigned char>(src[j + 1])) &&
+                std::isdigit(static_cast<unsigned char>(src[j + 2]))) {
+                double minutes = std::stoi(src.substr(i, j - i)) * 60 +
+                                 std::stoi(src.substr(j + 1, 2));
+                tokens.push_back({Token::NUMBER, src.substr(i, j + 3 - i), minutes, start});
+                i = j + 3;
+                continue;
+            }
+            char* end = nullptr;
+            double value = std::strtod(src.c_str() + i, &end);
+            if (end == src.c_str() + i) {
+                throw std::invalid_argument("Rule error at column " + std::to_string(i + 1) +
+                                            ": malformed number");
+            }
+            i = static_cast<std::size_t>(end - src.c_str());
+            tokens.push_back({Token::NUMBER, src.substr(start, i - start), value, start});
+        } else if (std::isalpha(static_cast<unsigned char>(c)) || c == '_') {
+            while (i < src.size() &&
+                   (std::isalnum(static_cast<unsigned char>(src[i])) || src[i] == '_')) {
+                ++i;
+            }
+            tokens.push_back({Token::IDENT, src.substr(start, i - start), 0.0, start});
+        } else {
+            static const char* two_char[] = {"&&", "||", "==", "!=", "<=", ">="};
+            std::string symbol(1, c);
+            for (const char* op : two_char) {
+                if (src.compare(i, 2, op) == 0) symbol = op;
+            }
+            if (symbol.size() == 1 && std::string("+-*/<>!(),").find(c) == std::string::npos) {
+                throw std::invalid_argument("Rule error at column " + std::to_string(i + 1) +
+                                            ": unexpected character '" + symbol + "'");
+            }
+            i += symbol.size();
+            tokens.push_back({Token::SYMBOL, symbol, 0.0, start});
+        }
+    }
+    tokens.push_back({Token::END, "", 0.0, src.size()});
+    return tokens;
+}
+
+/**
+ * @brief Expression tree node; children are indices into the node pool
+ */
+struct Node {
+    enum Kind { CONST, FIELD, INDICATOR, OP } kind;
+    double value;
+    int field;
+    std::size_t indicator;
+    RuleOp op;
+    int lhs;
+    int rhs;
+    int level;  // 0 = constant, 1 = per session, 2 = per candle
+};
+
+class Parser {
+private:
+    std::vector<Token> tokens_;
+    std::size_t next_ = 0;
+    
+    [[noreturn]] void fail(const std::string& message) const {
+        throw std::invalid_argument("Rule error at column " +
+                                    std::to_string(tokens_[next_].pos + 1) + ": " + message);
+    }
+    
+    bool accept(const char* symbol) {
+        if (tokens_[next_].kind == Token::SYMBOL && tokens_[next_].text == symbol) {
+            ++next_;
+            return true;
+        }
+        return false;
+    }
+    
+    void expect(const char* symbol) {
+        if (!accept(symbol)) fail(std::string("expected '") + symbol + "'");
+    }
+    
+    int add(const Node& node) {
+        nodes.push_back(node);
+        return static_cast<int>(nodes.size()) - 1;
+    }
+    
+    int constant(double value) {
+        return add({Node::CONST, value, 0, 0, RuleOp::ADD, -1, -1, 0});
+    }
+    
+    static bool isBoolean(const Node& node) {
+        return node.kind == Node::OP && node.op >= RuleOp::LT && node.op <= RuleOp::NOT;
+    }
+    
+    /**
+     * @brief Build an operator node, folding it when every input is constant
+     */
+    int makeOp(RuleOp op, int lhs, int rhs) {
+        const Node& a = nodes[lhs];
+        const Node& b = nodes[rhs];
+        if (a.kind == Node::CONST && b.kind == Node::CONST) {
+            return constant(applyRuleOp(op, a.value, b.value));
+        }
+        // Absorbing constants: false && x, true || x
+        if (op == RuleOp::AND && ((a.kind == Node::CONST && a.value == 0.0) ||
+                                  (b.kind == Node::CONST && b.value == 0.0))) {
+            return constant(0.0);
+        }
+        if (op == RuleOp::OR && ((a.kind == Node::CONST && a.value != 0.0) ||
+                                 (b.kind == Node::CONST && b.value != 0.0))) {
+            return constant(1.0);
+        }
+        // Neutral constants: true && cond, false || cond (cond already 0/1)
+        if ((op == RuleOp::AND || op == RuleOp::OR) &&
+            (a.kind == Node::CONST || b.kind == Node::CONST)) {
+            int other = a.kind == Node::CONST ? rhs : lhs;
+            if (isBoolean(nodes[other])) return other;
+        }
+        return add({Node::OP, 0.0, 0, 0, op, lhs, rhs, std::max(a.level, b.level)});
+    }
+    
+    template <typename Next>
+    int binary(Next next, std::initializer_list<std::pair<const char*, RuleOp>> ops) {
+        int lhs = (this->*next)();
+        while (true) {
+            bool matched = false;
+            for (const auto& entry : ops) {
+                if (accept(entry.first)) {
+                    lhs = makeOp(entry.second, lhs, (this->*next)());
+                    matched = true;
+                    break;
+                }
+            }
+            if (!matched) return lhs;
+        }
+    }
+    
+    int parseOr() { return binary(&Parser::parseAnd, {{"||", RuleOp::OR}}); }
+    int parseAnd() { return binary(&Parser::parseEqual, {{"&&", RuleOp::AND}}); }
+    int parseEqual() {
+        return binary(&Parser::parseCompare, {{"==", RuleOp::EQ}, {"!=", RuleOp::NE}});
+    }
+    int parseCompare() {
+        return binary(&Parser::parseSum, {{"<=", RuleOp::LE}, {">=", RuleOp::GE},
+                                          {"<", RuleOp::LT}, {">", RuleOp::GT}});
+    }
+    int parseSum() {
+        return binary(&Parser::parseProduct, {{"+", RuleOp::ADD}, {"-", RuleOp::SUB}});
+    }
+    int parseProduct() {
+        return binary(&Parser::parseUnary, {{"*", RuleOp::MUL}, {"/", RuleOp::DIV}});
+    }
+    
+    int parseUnary() {
+        if (accept("!")) {
+            int operand = parseUnary();
+            return makeOp(RuleOp::NOT, operand, operand);
+        }
+        if (accept("-")) {
+            int operand = parseUnary();
+            return makeOp(RuleOp::NEG, operand, operand);
+        }
+        return parsePrimary();
+    }
+    
+    static bool priceSource(const std::string& name, PriceSource& source) {
+        if (name == "open") source = PriceSource::OPEN;
+        else if (name == "high") source = PriceSource::HIGH;
+        else if (name == "low") source = PriceSource::LOW;
+        else if (name == "close") source = PriceSource::CLOSE;
+        else return false;
+        return true;
+    }
+    
+    int parseIndicator(IndicatorType type, PriceSource source) {
+        int period_node = parseOr();
+        const Node& period = nodes[period_node];
+        if (period.kind != Node::CONST || period.value < 1 ||
+            period.value != std::floor(period.value) || period.value > 100000) {
+            fail("indicator period must be a positive integer constant");
+        }
+        if (accept(",")) {
+            const Token& token = tokens_[next_];
+            if (token.kind != Token::IDENT || !priceSource(token.text, source)) {
+                fail("expected price source (open, high, low, close)");
+            }
+            ++next_;
+        }
+        expect(")");
+        
+        RuleIndicator indicator{type, static_cast<int>(period.value), source};
+        auto it = std::find(indicators.begin(), indicators.end(), indicator);
+        std::size_t slot = static_cast<std::size_t>(it - indicators.begin());
+        if (it == indicators.end()) indicators.push_back(indicator);
+        return add({Node::INDICATOR, 0.0, 0, slot, RuleOp::ADD, -1, -1, 2});
+    }
+    
+    int parsePrimary() {
+        const Token token = tokens_[next_];
+        if (token.kind == Token::NUMBER) {
+            ++next_;
+            return constant(token.number);
+        }
+        if (accept("(")) {
+            int inner = parseOr();
+            expect(")");
+            return inner;
+        }
+        if (token.kind != Token::IDENT) fail("expected a value");
+        ++next_;
+        
+        const std::string& name = token.text;
+        if (name == "true") return constant(1.0);
+        if (name == "false") return constant(0.0);
+        
+        if (accept("(")) {
+            if (name == "ema") return parseIndicator(IndicatorType::EMA, PriceSource::CLOSE);
+            if (name == "lowest") return parseIndicator(IndicatorType::ROLLING_MIN, PriceSource::LOW);
+            if (name == "highest") return parseIndicator(IndicatorType::ROLLING_MAX, PriceSource::HIGH);
+            if (name == "abs") {
+                int operand = parseOr();
+                expect(")");
+                return makeOp(RuleOp::ABS, operand, operand);
+            }
+            if (name == "min" || name == "max") {
+                int lhs = parseOr();
+                expect(",");
+                int rhs = parseOr();
+                expect(")");
+                return makeOp(name == "min" ? RuleOp::MIN : RuleOp::MAX, lhs, rhs);
+            }
+            next_ -= 2;
+            fail("unknown function '" + name + "'");
+        }
+        
+        static const char* fields[] = {"open", "high", "low", "close", "volume", "minute",
+                                       "prev_close", "setup_open", "setup_high",
+                                       "setup_low", "setup_close"};
+        for (int f = 0; f < static_cast<int>(RuleField::COUNT); ++f) {
+            if (name == fields[f]) {
+                int level = f == static_cast<int>(RuleField::PREV_CLOSE) ? 1 : 2;
+                return add({Node::FIELD, 0.0, f, 0, RuleOp::ADD, -1, -1, level});
+            }
+        }
+        --next_;
+        fail("unknown variable '" + name + "'");
+    }
+    
+public:
+    std::vector<Node> nodes;
+    std::vector<RuleIndicator> indicators;
+    
+    explicit Parser(const std::string& source) : tokens_(tokenize(source)) {}
+    
+    int parse() {
+        if (tokens_.front().kind == Token::END) fail("empty rule");
+        int root = parseOr();
+        if (tokens_[next_].kind != Token::END) fail("unexpected '" + tokens_[next_].text + "'");
+        return root;
+    }
+};
+
+}  // namespace rule_detail
+
+
+// ============================================================================
+// COMPILED PROGRAM
+// ============================================================================
+
+/**
+ * @class RuleProgram
+ * @brief Immutable compiled rule; register files are owned by the caller
+ *
+ * One program can be shared by many threads; each evaluation context keeps
+ * its own Registers (see makeRegisters / beginSession / evaluate).
+ */
+class RuleProgram {
+public:
+    using Registers = std::vector<double>;
+    static constexpr std::size_t FIELDS = static_cast<std::size_t>(RuleField::COUNT);
+    
+private:
+    std::string source_;
+    std::vector<RuleIndicator> indicators_;
+    std::vector<double> constants_;
+    std::vector<RuleInstruction> session_code_;
+    std::vector<RuleInstruction> candle_code_;
+    std::size_t register_count_ = 0;
+    std::size_t result_ = 0;
+    std::uint32_t field_mask_ = 0;
+    
+    std::size_t constantBase() const { return FIELDS + indicators_.size(); }
+    
+    std::size_t emit(const std::vector<rule_detail::Node>& nodes, int index) {
+        const rule_detail::Node& node = nodes[index];
+        switch (node.kind) {
+            case rule_detail::Node::CONST: {
+                auto it = std::find(constants_.begin(), constants_.end(), node.value);
+                std::size_t slot = static_cast<std::size_t>(it - constants_.begin());
+                if (it == constants_.end()) constants_.push_back(node.value);
+                return constantBase() + slot;
+            }
+            case rule_detail::Node::FIELD:
+                field_mask_ |= 1u << node.field;
+                return static_cast<std::size_t>(node.field);
+            case rule_detail::Node::INDICATOR:
+                return FIELDS + node.indicator;
+            case rule_detail::Node::OP:
+                break;
+        }
+        
+        std::size_t a = emit(nodes, node.lhs);
+        std::size_t b = emit(nodes, node.rhs);
+        std::size_t dst = register_count_++;
+        if (dst > 0xFFFF) throw std::invalid_argument("Rule too large");
+        RuleInstruction instruction{node.op, static_cast<std::uint16_t>(dst),
+                                    static_cast<std::uint16_t>(a),
+                                    static_cast<std::uint16_t>(b)};
+        (node.level <= 1 ? session_code_ : candle_code_).push_back(instruction);
+        return dst;
+    }
+    
+    void collectConstants(const std::vector<rule_detail::Node>& nodes, int index) {
+        const rule_detail::Node& node = nodes[index];
+        if (node.kind == rule_detail::Node::OP) {
+            collectConstants(nodes, node.lhs);
+            collectConstants(nodes, node.rhs);
+        } else if (node.kind == rule_detail::Node::CONST &&
+                   std::find(constants_.begin(), constants_.end(), node.value) ==
+                       constants_.end()) {
+            constants_.push_back(node.value);
+        }
+    }
+    
+    /**
+     * @brief One instruction across lanes; a non-zero Count fixes the trip
+     *        count at compile time so full blocks vectorise even at -O2
+     * 
+     * The destination is always a fresh temporary, never an input, so the
+     * restrict qualifiers hold (x == y for unary operators is read-only).
+     */
+    template <std::size_t Count>
+    static void runLanes(RuleOp op, double* __restrict d, const double* __restrict x,
+                         const double* __restrict y, std::size_t len) {
+        const std::size_t count = Count ? Count : len;
+        switch (op) {
+            case RuleOp::ADD: for (std::size_t j = 0; j < count; ++j) d[j] = x[j] + y[j]; break;
+            case RuleOp::SUB: for (std::size_t j = 0; j < count; ++j) d[j] = x[j] - y[j]; break;
+            case RuleOp::MUL: for (std::size_t j = 0; j < count; ++j) d[j] = x[j] * y[j]; break;
+            case RuleOp::DIV: for (std::size_t j = 0; j < count; ++j) d[j] = x[j] / y[j]; break;
+            case RuleOp::NEG: for (std::size_t j = 0; j < count; ++j) d[j] = -x[j]; break;
+            case RuleOp::LT:  for (std::size_t j = 0; j < count; ++j) d[j] = x[j] < y[j] ? 1.0 : 0.0; break;
+            case RuleOp::LE:  for (std::size_t j = 0; j < count; ++j) d[j] = x[j] <= y[j] ? 1.0 : 0.0; break;
+            case RuleOp::GT:  for (std::size_t j = 0; j < count; ++j) d[j] = x[j] > y[j] ? 1.0 : 0.0; break;
+            case RuleOp::GE:  for (std::size_t j = 0; j < count; ++j) d[j] = x[j] >= y[j] ? 1.0 : 0.0; break;
+            case RuleOp::EQ:  for (std::size_t j = 0; j < count; ++j) d[j] = x[j] == y[j] ? 1.0 : 0.0; break;
+            case RuleOp::NE:  for (std::size_t j = 0; j < count; ++j) d[j] = x[j] != y[j] ? 1.0 : 0.0; break;
+            case RuleOp::AND:
+                for (std::size_t j = 0; j < count; ++j) d[j] = (x[j] != 0.0) & (y[j] != 0.0) ? 1.0 : 0.0;
+                break;
+            case RuleOp::OR:
+                for (std::size_t j = 0; j < count; ++j) d[j] = (x[j] != 0.0) | (y[j] != 0.0) ? 1.0 : 0.0;
+                break;
+            case RuleOp::NOT: for (std::size_t j = 0; j < count; ++j) d[j] = x[j] == 0.0 ? 1.0 : 0.0; break;
+            case RuleOp::ABS: for (std::size_t j = 0; j < count; ++j) d[j] = std::fabs(x[j]); break;
+            case RuleOp::MIN: for (std::size_t j = 0; j < count; ++j) d[j] = y[j] < x[j] ? y[j] : x[j]; break;
+            case RuleOp::MAX: for (std::size_t j = 0; j < count; ++j) d[j] = x[j] < y[j] ? y[j] : x[j]; break;
+        }
+    }
+    
+    static void run(const std::vector<RuleInstruction>& code, double* regs) {
+        for (const auto& ins : code) {
+            regs[ins.dst] = applyRuleOp(ins.op, regs[ins.a], regs[ins.b]);
+        }
+    }
+    
+public:
+    /**
+     * @brief Compile a rule; throws std::invalid_argument with the column on error
+     */
+    static RuleProgram compile(const std::string& source) {
+        rule_detail::Parser parser(source);
+        int root = parser.parse();
+        
+        RuleProgram program;
+        program.source_ = source;
+        program.indicators_ = parser.indicators;
+        
+        // Constants are numbered before temporaries, so collect them first
+        program.collectConstants(parser.nodes, root);
+        program.register_count_ = program.constantBase() + program.constants_.size();
+        program.result_ = program.emit(parser.nodes, root);
+        return program;
+    }
+    
+    const std::string& source() const { return source_; }
+    const std::vector<RuleIndicator>& indicators() const { return indicators_; }
+    std::size_t registerCount() const { return register_count_; }
+    std::size_t instructionCount() const { return candle_code_.size(); }
+    std::size_t sessionInstructionCount() const { return session_code_.size(); }
+    
+    bool usesField(RuleField field) const {
+        return (field_mask_ >> static_cast<int>(field)) & 1u;
+    }
+    
+    bool usesSetupFields() const {
+        return usesField(RuleField::SETUP_OPEN) || usesField(RuleField::SETUP_HIGH) ||
+               usesField(RuleField::SETUP_LOW) || usesField(RuleField::SETUP_CLOSE);
+    }
+    
+    static std::size_t fieldRegister(RuleField field) { return static_cast<std::size_t>(field); }
+    std::size_t indicatorRegister(std::size_t slot) const { return FIELDS + slot; }
+    
+    Registers makeRegisters() const {
+        Registers regs(register_count_, 0.0);
+        std::copy(constants_.begin(), constants_.end(), regs.begin() + constantBase());
+        return regs;
+    }
+    
+    /**
+     * @brief Set prev_close and run the per-session prelude
+     */
+    void beginSession(Registers& regs, double previous_day_close) const {
+        regs[fieldRegister(RuleField::PREV_CLOSE)] = previous_day_close;
+        run(session_code_, regs.data());
+    }
+    
+    /**
+     * @brief Evaluate with field and indicator registers already filled
+     */
+    double evaluate(Registers& regs) const {
+        run(candle_code_, regs.data());
+        return regs[result_];
+    }
+    
+    /**
+     * @brief Evaluate the rule on every candle of a session
+     * @param indicator_series One series per indicators()[i], columns.size() long
+     * @param out Receives 1 where the rule holds, 0 elsewhere
+     *
+     * Processes BLOCK candles per instruction so each instruction is a
+     * straight loop over contiguous doubles.
+     */
+    void evaluateColumns(const CandleColumns& columns,
+                         const std::vector<const double*>& indicator_series,
+                         double previous_day_close, std::vector<std::uint8_t>& out) const {
+        static constexpr std::size_t BLOCK = 256;
+        
+        if (usesSetupFields()) {
+            throw std::invalid_argument("setup_* fields are not available in batch mode");
+        }
+        if (indicator_series.size() != indicators_.size()) {
+            throw std::invalid_argument("Rule needs one series per indicator");
+        }
+        
+        const std::size_t n = columns.size();
+        out.assign(n, 0);
+        
+        if (n == 0) return;
+        
+        // Scalar pass for constants and the session prelude, then broadcast
+        // only the registers the per-candle code reads
+        Registers scalars = makeRegisters();
+        beginSession(scalars, previous_day_close);
+        
+        thread_local std::vector<double> storage;
+        thread_local std::vector<const double*> src;
+        storage.resize(std::max(storage.size(), register_count_ * BLOCK));
+        src.assign(register_count_, nullptr);
+        
+        const std::size_t width = std::min(BLOCK, n);
+        auto broadcast = [&](std::size_t r) {
+            std::fill_n(storage.data() + r * BLOCK, width, scalars[r]);
+            src[r] = storage.data() + r * BLOCK;
+        };
+        for (std::size_t r = constantBase(); r < constantBase() + constants_.size(); ++r) {
+            broadcast(r);
+        }
+        for (const auto& ins : session_code_) broadcast(ins.dst);
+        broadcast(fieldRegister(RuleField::PREV_CLOSE));
+        double* minute = storage.data() + fieldRegister(RuleField::MINUTE) * BLOCK;
+        src[fieldRegister(RuleField::MINUTE)] = minute;
+        
+        for (std::size_t begin = 0; begin < n; begin += BLOCK) {
+            const std::size_t len = std::min(BLOCK, n - begin);
+            src[fieldRegister(RuleField::OPEN)] = columns.open.data() + begin;
+            src[fieldRegister(RuleField::HIGH)] = columns.high.data() + begin;
+            src[fieldRegister(RuleField::LOW)] = columns.low.data() + begin;
+            src[fieldRegister(RuleField::CLOSE)] = columns.close.data() + begin;
+            if (usesField(RuleField::VOLUME)) {
+                src[fieldRegister(RuleField::VOLUME)] = columns.volume.data() + begin;
+            }
+            if (usesField(RuleField::MINUTE)) {
+                for (std::size_t j = 0; j < len; ++j) minute[j] = columns.minute[begin + j];
+            }
+            for (std::size_t i = 0; i < indicators_.size(); ++i) {
+                src[FIELDS + i] = indicator_series[i] + begin;
+            }
+            
+            for (const auto& ins : candle_code_) {
+                double* d = storage.data() + ins.dst * BLOCK;
+                if (len == BLOCK) {
+                    runLanes<BLOCK>(ins.op, d, src[ins.a], src[ins.b], len);
+                } else {
+                    runLanes<0>(ins.op, d, src[ins.a], src[ins.b], len);
+                }
+                src[ins.dst] = d;
+            }
+            
+            const double* __restrict result = src[result_];
+            std::uint8_t* __restrict mask = out.data() + begin;
+            for (std::size_t j = 0; j < len; ++j) mask[j] = result[j] != 0.0;
+        }
+    }
+    
+    /**
+     * @brief Human-readable listing (debugging aid)
+     */
+    void disassemble(std::ostream& os) const {
+        static const char* names[] = {"add", "sub", "mul", "div", "neg", "lt", "le", "gt",
+                                      "ge", "eq", "ne", "and", "or", "not", "abs", "min", "max"};
+        auto print = [&](const char* label, const std::vector<RuleInstruction>& code) {
+            os << label << ":\n";
+            for (const auto& ins : code) {
+                os << "  r" << ins.dst << " = " << names[static_cast<int>(ins.op)]
+                   << " r" << ins.a << ", r" << ins.b << "\n";
+            }
+        };
+        print("session", session_code_);
+        print("candle", candle_code_);
+        os << "result: r" << result_ << "\n";
+    }
+};
+
+
+// ============================================================================
+// RULE STRATEGY
+// ============================================================================
+
+/**
+ * @class RuleStrategy
+ * @brief Two-stage pattern strategy driven by compiled rules
+ *
+ * Same state machine as TwoCandelPatternStrategy with the conditions
+ * supplied as text:
+ *   - setup:   evaluated while no setup is pending; when true the candle is
+ *              remembered (its fields become setup_open/high/low/close)
+ *   - trigger: evaluated on later candles; when true a SELL signal fires
+ *              and the setup is cleared
+ *
+ * RuleStrategy("open >= prev_close * 1.03 && low > ema(5)", "low < setup_low")
+ * reproduces TwoCandelPatternStrategy with the default parameters.
+ */
+class RuleStrategy {
+private:
+    std::string name_;
+    RuleProgram setup_;
+    RuleProgram trigger_;
+    RuleProgram::Registers setup_regs_;
+    RuleProgram::Registers trigger_regs_;
+    
+    // Indicators live in the engine's registry once attached, else in our own
+    IndicatorRegistry own_indicators_;
+    const IndicatorRegistry* shared_indicators_;
+    std::vector<IndicatorHandle> setup_handles_;
+    std::vector<IndicatorHandle> trigger_handles_;
+    
+    Candle setup_candle_;
+    bool setup_valid_;
+    
+    static std::vector<IndicatorHandle> resolve(const RuleProgram& program,
+                                                IndicatorRegistry& registry) {
+        std::vector<IndicatorHandle> handles;
+        for (const auto& indicator : program.indicators()) {
+            handles.push_back(registry.request(indicator.type, indicator.period,
+                                               indicator.source));
+        }
+        return handles;
+    }
+    
+    const IndicatorRegistry& indicators() const {
+        return shared_indicators_ ? *shared_indicators_ : own_indicators_;
+    }
+    
+    void load(const RuleProgram& program, RuleProgram::Registers& regs,
+              const std::vector<IndicatorHandle>& handles, const Candle& candle) const {
+        regs[RuleProgram::fieldRegister(RuleField::OPEN)] = candle.open;
+        regs[RuleProgram::fieldRegister(RuleField::HIGH)] = candle.high;
+        regs[RuleProgram::fieldRegister(RuleField::LOW)] = candle.low;
+        regs[RuleProgram::fieldRegister(RuleField::CLOSE)] = candle.close;
+        regs[RuleProgram::fieldRegister(RuleField::VOLUME)] = candle.volume;
+        if (program.usesField(RuleField::MINUTE)) {
+            regs[RuleProgram::fieldRegister(RuleField::MINUTE)] =
+                parseMinuteOfDay(candle.timestamp);
+        }
+        const IndicatorRegistry& registry = indicators();
+        for (std::size_t i = 0; i < handles.size(); ++i) {
+            regs[program.indicatorRegister(i)] = registry.value(handles[i]);
+        }
+    }
+    
+public:
+    RuleStrategy(const std::string& setup, const std::string& trigger = "low < setup_low",
+                 const std::string& name = "Rule Pattern")
+        : name_(name),
+          setup_(RuleProgram::compile(setup)),
+          trigger_(RuleProgram::compile(trigger)),
+          setup_regs_(setup_.makeRegisters()),
+          trigger_regs_(trigger_.makeRegisters()),
+          shared_indicators_(nullptr),
+          setup_valid_(false) {
+        if (setup_.usesSetupFields()) {
+            throw std::invalid_argument("setup rule cannot reference setup_* fields");
+        }
+        setup_handles_ = resolve(setup_, own_indicators_);
+        trigger_handles_ = resolve(trigger_, own_indicators_);
+    }
+    
+    /**
+     * @brief Resolve indicator handles in a shared registry (see TwoCandelPatternStrategy::attach)
+     */
+    void attach(IndicatorRegistry& registry) {
+        setup_handles_ = resolve(setup_, registry);
+        trigger_handles_ = resolve(trigger_, registry);
+        shared_indicators_ = &registry;
+    }
+    
+    void initialize(double prev_close) {
+        setup_valid_ = false;
+        own_indicators_.reset();
+        setup_.beginSession(setup_regs_, prev_close);
+        trigger_.beginSession(trigger_regs_, prev_close);
+    }
+    
+    bool processCandle(const Candle& candle) {
+        if (!shared_indicators_) own_indicators_.update(candle);
+        if (!isReady()) return false;
+        
+        if (!setup_valid_) {
+            load(setup_, setup_regs_, setup_handles_, candle);
+            if (setup_.evaluate(setup_regs_) != 0.0) {
+                setup_candle_ = candle;
+                setup_valid_ = true;
+                trigger_regs_[RuleProgram::fieldRegister(RuleField::SETUP_OPEN)] = candle.open;
+                trigger_regs_[RuleProgram::fieldRegister(RuleField::SETUP_HIGH)] = candle.high;
+                trigger_regs_[RuleProgram::fieldRegister(RuleField::SETUP_LOW)] = candle.low;
+                trigger_regs_[RuleProgram::fieldRegister(RuleField::SETUP_CLOSE)] = candle.close;
+            }
+            return false;
+        }
+        
+        load(trigger_, trigger_regs_, trigger_handles_, candle);
+        if (trigger_.evaluate(trigger_regs_) != 0.0) {
+            setup_valid_ = false;
+            return true;
+        }
+        return false;
+    }
+    
+    // Engine strategy interface (see is_strategy)
+    bool isReady() const {
+        const IndicatorRegistry& registry = indicators();
+        for (IndicatorHandle h : setup_handles_) {
+            if (!registry.isReady(h)) return false;
+        }
+        for (IndicatorHandle h : trigger_handles_) {
+            if (!registry.isReady(h)) return false;
+        }
+        return true;
+    }
+    
+    void logIndicators(std::ostream& os) const {
+        const IndicatorRegistry& registry = indicators();
+        const char* separator = "";
+        for (std::size_t i = 0; i < setup_handles_.size(); ++i) {
+            os << separator << setup_.indicators()[i].name() << ":"
+               << registry.value(setup_handles_[i]);
+            separator = " ";
+        }
+        for (std::size_t i = 0; i < trigger_handles_.size(); ++i) {
+            if (std::find(setup_.indicators().begin(), setup_.indicators().end(),
+                          trigger_.indicators()[i]) != setup_.indicators().end()) {
+                continue;
+            }
+            os << separator << trigger_.indicators()[i].name() << ":"
+               << registry.value(trigger_handles_[i]);
+            separator = " ";
+        }
+    }
+    
+    const char* getSignalName() const { return name_.c_str(); }
+    
+    const RuleProgram& getSetupProgram() const { return setup_; }
+    const RuleProgram& getTriggerProgram() const { return trigger_; }
+    bool isSetupPending() const { return setup_valid_; }
+    const Candle& getSetupCandle() const { return setup_candle_; }
+};
+
+#endif // RULE_DSL_HPP
@@ -0,0 +1,83 @@
+#ifndef SESSION_INDEX_HPP
+#define SESSION_INDEX_HPP
+
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include "candle_columns.hpp"
+
+/**
+ * @file session_index.hpp
+ * @brief Per-session pre-screen summary for gap-up strategies
+ * 
+ * The strategy can only fire in a session where some candle opens at
+ * least (1 + gap_threshold) × previous_day_close. Built once at load, the
+ * summary lets batch runners rule a session out with one comparison,
+ * before any candle or indicator is touched. Across a large universe most
+ * symbol-days never gap up, so most sessions are skipped outright.
+ */
+
+/**
+ * @struct SessionIndex
+ * @brief Max open / gap ratio, first gap candle and session range
+ */
+struct SessionIndex {
+    double previous_day_close = 0.0;
+    double max_open = -std::numeric_limits<double>::infinity();
+    double max_gap_ratio = 0.0;         // max_open / previous_day_close
+    double session_high = -std::numeric_limits<double>::infinity();
+    double session_low = std::numeric_limits<double>::infinity();
+    std::uint32_t candle_count = 0;
+    
+    // First candle with open >= prev_close * (1 + base_gap_threshold)
+    double base_gap_threshold = 0.0;
+    std::uint32_t first_gap_index = 0;  // candle_count if none
+    
+    /**
+     * @brief Can any candle satisfy the gap condition at this threshold?
+     * 
+     * Uses the same expression as the strategy, so the answer is exact.
+     */
+    bool canGapUp(double gap_threshold) const {
+        return max_open >= previous_day_close * (1.0 + gap_threshold);
+    }
+    
+    /**
+     * @brief Earliest candle that can qualify at this threshold
+     * 
+     * A higher threshold can only qualify a subset of the base candidates,
+     * so the scan may start at first_gap_index; below the base it starts at 0.
+     */
+    std::uint32_t scanStart(double gap_threshold) const {
+        return gap_threshold >= base_gap_threshold ? first_gap_index : 0;
+    }
+};
+
+/**
+ * @brief Build the index from a session's columns
+ * @param base_gap_threshold Lowest threshold the batch runs will use
+ */
+inline SessionIndex buildSessionIndex(const CandleColumns& columns, double previous_day_close,
+                                      double base_gap_threshold = 0.0) {
+    SessionIndex index;
+    index.previous_day_close = previous_day_close;
+    index.candle_count = static_cast<std::uint32_t>(columns.size());
+    index.base_gap_threshold = base_gap_threshold;
+    index.first_gap_index = index.candle_count;
+    
+    const double base_level = previous_day_close * (1.0 + base_gap_threshold);
+    for (std::size_t i = 0; i < columns.size(); ++i) {
+        index.max_open = std::max(index.max_open, columns.open[i]);
+        index.session_high = std::max(index.session_high, columns.high[i]);
+        index.session_low = std::min(index.session_low, columns.low[i]);
+        if (index.first_gap_index == index.candle_count && columns.open[i] >= base_level) {
+            index.first_gap_index = static_cast<std::uint32_t>(i);
+        }
+    }
+    if (previous_day_close > 0 && index.candle_count > 0) {
+        index.max_gap_ratio = index.max_open / previous_day_close;
+    }
+    return index;
+}
+
+#endif // SESSION_INDEX_HPP
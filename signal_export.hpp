@@ -0,0 +1,290 @@
+#ifndef SIGNAL_EXPORT_HPP
+#define SIGNAL_EXPORT_HPP
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <map>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include "binary_io.hpp"
+#include "indicator_cache.hpp"
+#include "market_universe.hpp"
+#include "parallel.hpp"
+#include "signal_scan.hpp"
+#include "trading_engine.hpp"
+
+/**
+ * @file signal_export.hpp
+ * @brief Signal-only research runs: where strategies fire, nothing else
+ * 
+ * Runs TwoCandelPatternStrategy variants over a MarketUniverse with the
+ * lane-parallel signal scanner and records every signal candle with the EMA
+ * values the strategy saw there. No orders, risk checks or console output:
+ * the cost per session is the cached EMA series plus one candle pass per
+ * EMA period for up to GapLaneScanner::LANES gap thresholds.
+ * 
+ * The output is a columnar binary file (one contiguous array per column)
+ * so research tools can map columns straight into numpy/pandas.
+ */
+
+// ============================================================================
+// SIGNAL TABLE
+// ============================================================================
+
+/**
+ * @struct SignalTable
+ * @brief Signal rows stored column by column
+ * 
+ * Rows are ordered by session (universe order), then strategy, then candle.
+ * Instrument and session columns index the string dictionaries; the strategy
+ * column indexes `strategies`.
+ */
+struct SignalTable {
+    std::vector<StrategyParams> strategies;
+    std::vector<std::string> instruments;
+    std::vector<std::string> sessions;
+    
+    std::vector<std::uint16_t> strategy;
+    std::vector<std::uint32_t> instrument;
+    std::vector<std::uint32_t> session;
+    std::vector<std::uint32_t> candle_index;
+    std::vector<double> ema_fast;           // EMA(ema_fast_period) of close at the signal
+    std::vector<double> ema_slow;           // EMA(ema_slow_period) of close at the signal
+    
+    std::size_t size() const { return candle_index.size(); }
+};
+
+// ============================================================================
+// SIGNAL EXPORTER
+// ============================================================================
+
+/**
+ * @class SignalExporter
+ * @brief Parallel signal scan of strategy variants across a universe
+ */
+class SignalExporter {
+private:
+    const MarketUniverse& universe_;
+    IndicatorSeriesCache& cache_;
+    unsigned threads_;
+    
+    struct SessionRows {
+        std::vector<std::uint16_t> strategy;
+        std::vector<std::uint32_t> candle_index;
+        std::vector<double> ema_fast;
+        std::vector<double> ema_slow;
+    };
+    
+public:
+    SignalExporter(const MarketUniverse& universe, IndicatorSeriesCache& cache,
+                   unsigned threads = 0)
+        : universe_(universe), cache_(cache),
+          threads_(threads ? threads : defaultThreadCount()) {}
+    
+    /**
+     * @brief Every signal of every strategy in every session
+     * 
+     * Signal indices match TwoCandelPatternStrategy::processCandle() fed the
+     * session candle by candle; sessions that cannot gap up are skipped
+     * without computing indicators.
+     */
+    SignalTable run(const std::vector<StrategyParams>& strategies) const {
+        if (strategies.size() > UINT16_MAX) {
+            throw std::invalid_argument("Too many strategies for one signal table");
+        }
+        
+        // Strategies sharing an EMA period are scanned together, lowest gap first
+        std::map<int, std::vector<std::size_t>> by_period;
+        for (std::size_t k = 0; k < strategies.size(); ++k) {
+            by_period[strategies[k].ema_slow_period].push_back(k);
+        }
+        for (auto& group : by_period) {
+            std::stable_sort(group.second.begin(), group.second.end(),
+                             [&](std::size_t a, std::size_t b) {
+                                 return strategies[a].gap_threshold < strategies[b].gap_threshold;
+                             });
+        }
+        
+        const std::size_t sessions = universe_.size();
+        std::vector<SessionRows> rows(sessions);
+        
+        parallelFor(sessions, threads_, [&](std::size_t s, unsigned) {
+            const MarketSession& session = universe_[s];
+            thread_local GapLaneScanner scanner;
+            thread_local std::vector<std::vector<std::uint32_t>> signals;
+            thread_local std::vector<SeriesPtr> slow_series;
+            signals.resize(strategies.size());
+            slow_series.assign(strategies.size(), nullptr);
+            for (auto& list : signals) list.clear();
+            
+            double gaps[GapLaneScanner::LANES];
+            std::vector<std::uint32_t> lane_signals[GapLaneScanner::LANES];
+            for (const auto& group : by_period) {
+                const std::vector<std::size_t>& members = group.second;
+                if (!session.index.canGapUp(strategies[members.front()].gap_threshold)) continue;
+                
+                auto slow = cache_.getOrCompute(session.data, session.columns,
+                                                IndicatorType::EMA, group.first);
+                for (std::size_t first = 0; first < members.size();
+                     first += GapLaneScanner::LANES) {
+                    const double min_gap = strategies[members[first]].gap_threshold;
+                    if (!session.index.canGapUp(min_gap)) break;
+                    const std::size_t lanes =
+                        std::min(GapLaneScanner::LANES, members.size() - first);
+                    for (std::size_t l = 0; l < lanes; ++l) {
+                        gaps[l] = strategies[members[first + l]].gap_threshold;
+                    }
+                    scanner.scan(session.columns, slow->data(), session.data.previous_day_close,
+                                 gaps, lanes, lane_signals, session.index.scanStart(min_gap));
+                    for (std::size_t l = 0; l < lanes; ++l) {
+                        signals[members[first + l]].swap(lane_signals[l]);
+                        slow_series[members[first + l]] = slow;
+                    }
+                }
+            }
+            
+            SessionRows& out = rows[s];
+            for (std::size_t k = 0; k < strategies.size(); ++k) {
+                if (signals[k].empty()) continue;
+                const auto& slow = *slow_series[k];
+                auto fast = cache_.getOrCompute(session.data, session.columns,
+                                                IndicatorType::EMA, strategies[k].ema_fast_period);
+                for (std::uint32_t i : signals[k]) {
+                    out.strategy.push_back(static_cast<std::uint16_t>(k));
+                    out.candle_index.push_back(i);
+                    out.ema_fast.push_back((*fast)[i]);
+                    out.ema_slow.push_back(slow[i]);
+                }
+            }
+        });
+        
+        // Concatenate in session order; dictionaries follow first appearance
+        SignalTable table;
+        table.strategies = strategies;
+        std::map<std::string, std::uint32_t> instrument_ids;
+        for (std::size_t s = 0; s < sessions; ++s) {
+            const MarketData& data = universe_[s].data;
+            auto inserted = instrument_ids.emplace(
+                data.instrument, static_cast<std::uint32_t>(table.instruments.size()));
+            if (inserted.second) table.instruments.push_back(data.instrument);
+            table.sessions.push_back(data.session);
+            
+            const SessionRows& r = rows[s];
+            table.strategy.insert(table.strategy.end(), r.strategy.begin(), r.strategy.end());
+            table.candle_index.insert(table.candle_index.end(),
+                                      r.candle_index.begin(), r.candle_index.end());
+            table.ema_fast.insert(table.ema_fast.end(), r.ema_fast.begin(), r.ema_fast.end());
+            table.ema_slow.insert(table.ema_slow.end(), r.ema_slow.begin(), r.ema_slow.end());
+            table.instrument.insert(table.instrument.end(), r.candle_index.size(),
+                                    inserted.first->second);
+            table.session.insert(table.session.end(), r.candle_index.size(),
+                                 static_cast<std::uint32_t>(s));
+        }
+        return table;
+    }
+};
+
+// ============================================================================
+// COLUMNAR FILE FORMAT
+// ============================================================================
+
+/**
+ * Layout (native byte order, like the indicator cache file):
+ *   "MSIG" u32 version u64 rows
+ *   u32 strategies, then per strategy: f64 gap, i32 ema_fast, i32 ema_slow
+ *   u32 instruments, then strings (u32 length + bytes)
+ *   u32 sessions, then strings
+ *   columns, each `rows` values back to back:
+ *     u16 strategy, u32 instrument, u32 session, u32 candle_index,
+ *     f64 ema_fast, f64 ema_slow
+ */
+namespace signal_file_detail {
+
+constexpr char MAGIC[4] = {'M', 'S', 'I', 'G'};
+constexpr std::uint32_t VERSION = 1;
+constexpr std::size_t ROW_BYTES = sizeof(std::uint16_t) + 3 * sizeof(std::uint32_t) +
+                                  2 * sizeof(double);
+constexpr std::size_t STRATEGY_BYTES = sizeof(double) + 2 * sizeof(std::int32_t);
+
+template <typename T>
+void writeColumn(BinaryWriter& out, const std::vector<T>& column) {
+    out.writeBytes(reinterpret_cast<const char*>(column.data()), column.size() * sizeof(T));
+}
+
+template <typename T>
+void readColumn(BinaryReader& in, std::vector<T>& column, std::size_t rows) {
+    column.resize(rows);
+    in.readBytes(reinterpret_cast<char*>(column.data()), rows * sizeof(T));
+}
+
+} // namespace signal_file_detail
+
+/**
+ * @brief Write a signal table in the columnar layout above
+ */
+inline void writeSignalTable(const std::string& filename, const SignalTable& table) {
+    BinaryWriter out;
+    out.writeBytes(signal_file_detail::MAGIC, sizeof(signal_file_detail::MAGIC));
+    out.write(signal_file_detail::VERSION);
+    out.write(static_cast<std::uint64_t>(table.size()));
+    
+    out.write(static_cast<std::uint32_t>(table.strategies.size()));
+    for (const auto& params : table.strategies) {
+        out.write(params.gap_threshold);
+        out.write(static_cast<std::int32_t>(params.ema_fast_period));
+        out.write(static_cast<std::int32_t>(params.ema_slow_period));
+    }
+    out.write(static_cast<std::uint32_t>(table.instruments.size()));
+    for (const auto& name : table.instruments) out.writeString(name);
+    out.write(static_cast<std::uint32_t>(table.sessions.size()));
+    for (const auto& name : table.sessions) out.writeString(name);
+    
+    signal_file_detail::writeColumn(out, table.strategy);
+    signal_file_detail::writeColumn(out, table.instrument);
+    signal_file_detail::writeColumn(out, table.session);
+    signal_file_detail::writeColumn(out, table.candle_index);
+    signal_file_detail::writeColumn(out, table.ema_fast);
+    signal_file_detail::writeColumn(out, table.ema_slow);
+    
+    writeBinaryFile(filename, out.data());
+}
+
+/**
+ * @brief Load a file written by writeSignalTable()
+ */
+inline SignalTable readSignalTable(const std::string& filename) {
+    std::string buffer = readBinaryFile(filename);
+    BinaryReader in(buffer);
+    
+    char magic[sizeof(signal_file_detail::MAGIC)];
+    in.readBytes(magic, sizeof(magic));
+    if (std::memcmp(magic, signal_file_detail::MAGIC, sizeof(magic)) != 0 ||
+        in.read<std::uint32_t>() != signal_file_detail::VERSION) {
+        throw std::runtime_error("Not a signal table file: " + filename);
+    }
+    
+    SignalTable table;
+    std::size_t rows = in.readCount<std::uint64_t>(signal_file_detail::ROW_BYTES);
+    table.strategies.resize(in.readCount<std::uint32_t>(signal_file_detail::STRATEGY_BYTES));
+    for (auto& params : table.strategies) {
+        params.gap_threshold = in.read<double>();
+        params.ema_fast_period = in.read<std::int32_t>();
+        params.ema_slow_period = in.read<std::int32_t>();
+    }
+    table.instruments.resize(in.readCount<std::uint32_t>(sizeof(std::uint32_t)));
+    for (auto& name : table.instruments) name = in.readString();
+    table.sessions.resize(in.readCount<std::uint32_t>(sizeof(std::uint32_t)));
+    for (auto& name : table.sessions) name = in.readString();
+    
+    signal_file_detail::readColumn(in, table.strategy, rows);
+    signal_file_detail::readColumn(in, table.instrument, rows);
+    signal_file_detail::readColumn(in, table.session, rows);
+    signal_file_detail::readColumn(in, table.candle_index, rows);
+    signal_file_detail::readColumn(in, table.ema_fast, rows);
+    signal_file_detail::readColumn(in, table.ema_slow, rows);
+    return table;
+}
+
+#endif // SIGNAL_EXPORT_HPP
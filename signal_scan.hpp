@@ -0,0 +1,438 @@
+#ifndef SIGNAL_SCAN_HPP
+#define SIGNAL_SCAN_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <vector>
+#include "candle_columns.hpp"
+
+#if defined(__AVX2__) || defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
+/**
+ * @file signal_scan.hpp
+ * @brief Vectorised whole-session pre-scan for two-candle signals
+ * 
+ * Both first-candle conditions are stateless per candle:
+ *   gap_condition: open >= prev_close * (1 + gap_threshold)
+ *   ema_condition: low  >  EMA_slow
+ * so they are computed as bitmasks over SoA columns (AVX2: 4 lanes,
+ * SSE2: 2 lanes, scalar fallback). The stateful part (watch the first
+ * candle's low for a breakdown) then runs only from candidate positions.
+ * 
+ * A session with no gap-up candle costs one vector pass over `open`; the
+ * EMA mask is only computed when some gap bit is set.
+ * 
+ * Comparisons are ordered (NaN compares false), matching the scalar code.
+ */
+
+inline std::size_t maskWords(std::size_t n) { return (n + 63) / 64; }
+
+/**
+ * @brief mask bit i = (open[i] >= level)
+ * @return True if any bit is set
+ */
+inline bool computeGapMask(const double* open, std::size_t n, double level,
+                           std::uint64_t* mask) {
+    std::uint64_t any = 0;
+    for (std::size_t w = 0; w < maskWords(n); ++w) {
+        const std::size_t base = w * 64;
+        const std::size_t count = n - base < 64 ? n - base : 64;
+        std::uint64_t bits = 0;
+        std::size_t i = 0;
+#if defined(__AVX2__)
+        const __m256d vlevel = _mm256_set1_pd(level);
+        for (; i + 4 <= count; i += 4) {
+            __m256d v = _mm256_loadu_pd(open + base + i);
+            std::uint64_t m = static_cast<std::uint64_t>(
+                _mm256_movemask_pd(_mm256_cmp_pd(v, vlevel, _CMP_GE_OQ)));
+            bits |= m << i;
+        }
+#elif defined(__SSE2__)
+        const __m128d vlevel = _mm_set1_pd(level);
+        for (; i + 2 <= count; i += 2) {
+            __m128d v = _mm_loadu_pd(open + base + i);
+            std::uint64_t m = static_cast<std::uint64_t>(
+                _mm_movemask_pd(_mm_cmpge_pd(v, vlevel)));
+            bits |= m << i;
+        }
+#endif
+        for (; i < count; ++i) {
+            bits |= static_cast<std::uint64_t>(open[base + i] >= level) << i;
+        }
+        mask[w] = bits;
+        any |= bits;
+    }
+    return any != 0;
+}
+
+/**
+ * @brief mask bit i = (a[i] > b[i])
+ */
+inline void computeGreaterMask(const double* a, const double* b, std::size_t n,
+                               std::uint64_t* mask) {
+    for (std::size_t w = 0; w < maskWords(n); ++w) {
+        const std::size_t base = w * 64;
+        const std::size_t count = n - base < 64 ? n - base : 64;
+        std::uint64_t bits = 0;
+        std::size_t i = 0;
+#if defined(__AVX2__)
+        for (; i + 4 <= count; i += 4) {
+            __m256d va = _mm256_loadu_pd(a + base + i);
+            __m256d vb = _mm256_loadu_pd(b + base + i);
+            std::uint64_t m = static_cast<std::uint64_t>(
+                _mm256_movemask_pd(_mm256_cmp_pd(va, vb, _CMP_GT_OQ)));
+            bits |= m << i;
+        }
+#elif defined(__SSE2__)
+        for (; i + 2 <= count; i += 2) {
+            __m128d va = _mm_loadu_pd(a + base + i);
+            __m128d vb = _mm_loadu_pd(b + base + i);
+            std::uint64_t m = static_cast<std::uint64_t>(
+                _mm_movemask_pd(_mm_cmpgt_pd(va, vb)));
+            bits |= m << i;
+        }
+#endif
+        for (; i < count; ++i) {
+            bits |= static_cast<std::uint64_t>(a[base + i] > b[base + i]) << i;
+        }
+        mask[w] = bits;
+    }
+}
+
+/**
+ * @brief First index i in [begin, n) with values[i] < level, or n
+ */
+inline std::size_t findFirstBelow(const double* values, std::size_t begin,
+                                  std::size_t n, double level) {
+    std::size_t i = begin;
+#if defined(__AVX2__)
+    const __m256d vlevel = _mm256_set1_pd(level);
+    for (; i + 4 <= n; i += 4) {
+        int m = _mm256_movemask_pd(
+            _mm256_cmp_pd(_mm256_loadu_pd(values + i), vlevel, _CMP_LT_OQ));
+        if (m) return i + static_cast<std::size_t>(__builtin_ctz(static_cast<unsigned>(m)));
+    }
+#elif defined(__SSE2__)
+    const __m128d vlevel = _mm_set1_pd(level);
+    for (; i + 2 <= n; i += 2) {
+        int m = _mm_movemask_pd(_mm_cmplt_pd(_mm_loadu_pd(values + i), vlevel));
+        if (m) return i + static_cast<std::size_t>(__builtin_ctz(static_cast<unsigned>(m)));
+    }
+#endif
+    for (; i < n; ++i) {
+        if (values[i] < level) return i;
+    }
+    return n;
+}
+
+/**
+ * @brief First index i in [begin, n) with values[i] <= low or values[i] >= high, or n
+ * 
+ * Used to jump an open position to its next exit candidate.
+ */
+inline std::size_t findFirstOutside(const double* values, std::size_t begin,
+                                    std::size_t n, double low, double high) {
+    std::size_t i = begin;
+#if defined(__AVX2__)
+    const __m256d vlow = _mm256_set1_pd(low);
+    const __m256d vhigh = _mm256_set1_pd(high);
+    for (; i + 4 <= n; i += 4) {
+        __m256d v = _mm256_loadu_pd(values + i);
+        int m = _mm256_movemask_pd(_mm256_or_pd(_mm256_cmp_pd(v, vlow, _CMP_LE_OQ),
+                                                _mm256_cmp_pd(v, vhigh, _CMP_GE_OQ)));
+        if (m) return i + static_cast<std::size_t>(__builtin_ctz(static_cast<unsigned>(m)));
+    }
+#elif defined(__SSE2__)
+    const __m128d vlow = _mm_set1_pd(low);
+    const __m128d vhigh = _mm_set1_pd(high);
+    for (; i + 2 <= n; i += 2) {
+        __m128d v = _mm_loadu_pd(values + i);
+        int m = _mm_movemask_pd(_mm_or_pd(_mm_cmple_pd(v, vlow), _mm_cmpge_pd(v, vhigh)));
+        if (m) return i + static_cast<std::size_t>(__builtin_ctz(static_cast<unsigned>(m)));
+    }
+#endif
+    for (; i < n; ++i) {
+        if (values[i] <= low || values[i] >= high) return i;
+    }
+    return n;
+}
+
+/**
+ * @brief First bar i in [begin, n) with low[i] <= low_level or high[i] >= high_level, or n
+ * 
+ * The bar-range counterpart of findFirstOutside: the first bar whose
+ * range reaches either trigger price.
+ */
+inline std::size_t findFirstBarOutside(const double* high, const double* low,
+                                       std::size_t begin, std::size_t n,
+                                       double low_level, double high_level) {
+    std::size_t i = begin;
+#if defined(__AVX2__)
+    const __m256d vlow = _mm256_set1_pd(low_level);
+    const __m256d vhigh = _mm256_set1_pd(high_level);
+    for (; i + 4 <= n; i += 4) {
+        int m = _mm256_movemask_pd(_mm256_or_pd(
+            _mm256_cmp_pd(_mm256_loadu_pd(low + i), vlow, _CMP_LE_OQ),
+            _mm256_cmp_pd(_mm256_loadu_pd(high + i), vhigh, _CMP_GE_OQ)));
+        if (m) return i + static_cast<std::size_t>(__builtin_ctz(static_cast<unsigned>(m)));
+    }
+#elif defined(__SSE2__)
+    const __m128d vlow = _mm_set1_pd(low_level);
+    const __m128d vhigh = _mm_set1_pd(high_level);
+    for (; i + 2 <= n; i += 2) {
+        int m = _mm_movemask_pd(_mm_or_pd(_mm_cmple_pd(_mm_loadu_pd(low + i), vlow),
+                                          _mm_cmpge_pd(_mm_loadu_pd(high + i), vhigh)));
+        if (m) return i + static_cast<std::size_t>(__builtin_ctz(static_cast<unsigned>(m)));
+    }
+#endif
+    for (; i < n; ++i) {
+        if (low[i] <= low_level || high[i] >= high_level) return i;
+    }
+    return n;
+}
+
+/**
+ * @brief First index i in [begin, n) with values[i] >= level, or n
+ */
+inline std::size_t findFirstAtLeast(const int* values, std::size_t begin,
+                                    std::size_t n, int level) {
+    std::size_t i = begin;
+#if defined(__AVX2__)
+    const __m256i vlevel = _mm256_set1_epi32(level);
+    for (; i + 8 <= n; i += 8) {
+        __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(values + i));
+        // values >= level  <=>  !(level > values)
+        unsigned m = ~static_cast<unsigned>(_mm256_movemask_ps(
+            _mm256_castsi256_ps(_mm256_cmpgt_epi32(vlevel, v)))) & 0xFFu;
+        if (m) return i + static_cast<std::size_t>(__builtin_ctz(m));
+    }
+#elif defined(__SSE2__)
+    const __m128i vlevel = _mm_set1_epi32(level);
+    for (; i + 4 <= n; i += 4) {
+        __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(values + i));
+        unsigned m = ~static_cast<unsigned>(_mm_movemask_ps(
+            _mm_castsi128_ps(_mm_cmplt_epi32(v, vlevel)))) & 0xFu;
+        if (m) return i + static_cast<std::size_t>(__builtin_ctz(m));
+    }
+#endif
+    for (; i < n; ++i) {
+        if (values[i] >= level) return i;
+    }
+    return n;
+}
+
+/**
+ * @brief First set bit at index >= from, or n
+ */
+inline std::size_t nextSetBit(const std::uint64_t* mask, std::size_t from, std::size_t n) {
+    if (from >= n) return n;
+    std::size_t w = from / 64;
+    std::uint64_t bits = mask[w] & (~std::uint64_t(0) << (from % 64));
+    const std::size_t words = maskWords(n);
+    for (;;) {
+        if (bits) {
+            std::size_t i = w * 64 + static_cast<std::size_t>(__builtin_ctzll(bits));
+            return i < n ? i : n;
+        }
+        if (++w >= words) return n;
+        bits = mask[w];
+    }
+}
+
+/**
+ * @class SignalScanner
+ * @brief Reusable buffers + whole-session signal search
+ * 
+ * Produces exactly the candle indices at which
+ * TwoCandelPatternStrategy::processCandle() returns true.
+ */
+class SignalScanner {
+private:
+    std::vector<std::uint64_t> gap_mask_;
+    std::vector<std::uint64_t> ema_mask_;
+    
+public:
+    /**
+     * @param ema_slow EMA_slow of close per candle
+     * @param signals Output: signal candle indices, ascending (cleared first)
+     * @param begin First candle that can qualify (e.g. SessionIndex::scanStart);
+     *              earlier candles are known not to gap up and are not read
+     * @return Number of signals
+     */
+    std::size_t scan(const CandleColumns& columns, const double* ema_slow,
+                     double previous_day_close, double gap_threshold,
+                     std::vector<std::uint32_t>& signals, std::size_t begin = 0) {
+        signals.clear();
+        const std::size_t n = columns.size();
+        if (begin >= n) return 0;
+        
+        // Masks stay index-aligned; words before `first_word` are never read
+        const std::size_t first_word = begin / 64;
+        const std::size_t offset = first_word * 64;
+        gap_mask_.resize(maskWords(n));
+        ema_mask_.resize(maskWords(n));
+        
+        const double level = previous_day_close * (1.0 + gap_threshold);
+        if (!computeGapMask(columns.open.data() + offset, n - offset, level,
+                            gap_mask_.data() + first_word)) {
+            return 0;  // No gap-up candle: nothing can qualify
+        }
+        
+        computeGreaterMask(columns.low.data() + offset, ema_slow + offset, n - offset,
+                           ema_mask_.data() + first_word);
+        for (std::size_t w = first_word; w < gap_mask_.size(); ++w) gap_mask_[w] &= ema_mask_[w];
+        
+        // State machine from candidates only: qualify at i, break down at j
+        const double* low = columns.low.data();
+        std::size_t i = nextSetBit(gap_mask_.data(), begin, n);
+        while (i < n) {
+            std::size_t j = findFirstBelow(low, i + 1, n, low[i]);
+            if (j >= n) break;
+            signals.push_back(static_cast<std::uint32_t>(j));
+            i = nextSetBit(gap_mask_.data(), j + 1, n);
+        }
+        return signals.size();
+    }
+};
+
+/**
+ * @class GapLaneScanner
+ * @brief One pass over a session for up to LANES gap thresholds at once
+ * 
+ * Each lane runs TwoCandelPatternStrategy's state machine for its own
+ * threshold (armed flag + first-candle low); all lanes share the EMA_slow
+ * filter, so a candle's open/low/EMA are loaded once and compared against
+ * every lane. The per-lane update is a masked blend across lanes (AVX2:
+ * 4 per op, SSE2: 2, scalar fallback) with no data-dependent branches.
+ * 
+ * While no lane is armed, nothing can change until a candle opens at or
+ * above the lowest lane's level, so the walk jumps between such candles
+ * using the gap mask of the lowest threshold.
+ */
+class GapLaneScanner {
+public:
+    static constexpr std::size_t LANES = 16;
+    
+private:
+    // Armed flags are all-ones / all-zero bit patterns, used as blend masks
+    alignas(64) double level_[LANES];
+    alignas(64) double first_low_[LANES];
+    alignas(64) double armed_[LANES];
+    std::vector<std::uint64_t> gap_mask_;
+    
+    struct LaneStep {
+        std::uint32_t fired;    // bit l: lane l signals at this candle
+        std::uint32_t armed;    // bit l: lane l holds a first candle afterwards
+    };
+    
+    /**
+     * @brief Advance every lane by one candle
+     */
+    LaneStep step(double open, double low, double ema_slow) {
+        LaneStep out{0, 0};
+#if defined(__AVX2__)
+        const __m256d vopen = _mm256_set1_pd(open);
+        const __m256d vlow = _mm256_set1_pd(low);
+        const __m256d ema_ok = _mm256_cmp_pd(vlow, _mm256_set1_pd(ema_slow), _CMP_GT_OQ);
+        for (std::size_t l = 0; l < LANES; l += 4) {
+            __m256d armed = _mm256_load_pd(armed_ + l);
+            __m256d first_low = _mm256_load_pd(first_low_ + l);
+            __m256d gap_ok = _mm256_cmp_pd(vopen, _mm256_load_pd(level_ + l), _CMP_GE_OQ);
+            __m256d arm = _mm256_andnot_pd(armed, _mm256_and_pd(gap_ok, ema_ok));
+            __m256d fire = _mm256_and_pd(armed, _mm256_cmp_pd(vlow, first_low, _CMP_LT_OQ));
+            armed = _mm256_or_pd(_mm256_andnot_pd(fire, armed), arm);
+            _mm256_store_pd(first_low_ + l, _mm256_blendv_pd(first_low, vlow, arm));
+            _mm256_store_pd(armed_ + l, armed);
+            out.fired |= static_cast<std::uint32_t>(_mm256_movemask_pd(fire)) << l;
+            out.armed |= static_cast<std::uint32_t>(_mm256_movemask_pd(armed)) << l;
+        }
+#elif defined(__SSE2__)
+        const __m128d vopen = _mm_set1_pd(open);
+        const __m128d vlow = _mm_set1_pd(low);
+        const __m128d ema_ok = _mm_cmpgt_pd(vlow, _mm_set1_pd(ema_slow));
+        for (std::size_t l = 0; l < LANES; l += 2) {
+            __m128d armed = _mm_load_pd(armed_ + l);
+            __m128d first_low = _mm_load_pd(first_low_ + l);
+            __m128d gap_ok = _mm_cmpge_pd(vopen, _mm_load_pd(level_ + l));
+            __m128d arm = _mm_andnot_pd(armed, _mm_and_pd(gap_ok, ema_ok));
+            __m128d fire = _mm_and_pd(armed, _mm_cmplt_pd(vlow, first_low));
+            armed = _mm_or_pd(_mm_andnot_pd(fire, armed), arm);
+            _mm_store_pd(first_low_ + l,
+                         _mm_or_pd(_mm_and_pd(arm, vlow), _mm_andnot_pd(arm, first_low)));
+            _mm_store_pd(armed_ + l, armed);
+            out.fired |= static_cast<std::uint32_t>(_mm_movemask_pd(fire)) << l;
+            out.armed |= static_cast<std::uint32_t>(_mm_movemask_pd(armed)) << l;
+        }
+#else
+        const bool ema_ok = low > ema_slow;
+        for (std::size_t l = 0; l < LANES; ++l) {
+            const bool armed = armed_[l] != 0.0;
+            const bool arm = !armed && open >= level_[l] && ema_ok;
+            const bool fire = armed && low < first_low_[l];
+            first_low_[l] = arm ? low : first_low_[l];
+            armed_[l] = (armed && !fire) || arm ? 1.0 : 0.0;
+            out.fired |= static_cast<std::uint32_t>(fire) << l;
+            out.armed |= static_cast<std::uint32_t>(armed_[l] != 0.0) << l;
+        }
+#endif
+        return out;
+    }
+    
+public:
+    /**
+     * @param gap_thresholds One threshold per lane (at most LANES)
+     * @param signals Output: signals[l] receives lane l's signal candle
+     *        indices, ascending (cleared first)
+     * @param begin First candle that can qualify for the lowest threshold
+     * @return Total number of signals across lanes
+     * 
+     * Lane l yields exactly SignalScanner::scan() at gap_thresholds[l].
+     */
+    std::size_t scan(const CandleColumns& columns, const double* ema_slow,
+                     double previous_day_close, const double* gap_thresholds,
+                     std::size_t lanes, std::vector<std::uint32_t>* signals,
+                     std::size_t begin = 0) {
+        if (lanes > LANES) lanes = LANES;
+        for (std::size_t l = 0; l < lanes; ++l) signals[l].clear();
+        const std::size_t n = columns.size();
+        if (lanes == 0 || begin >= n) return 0;
+        
+        // Unused lanes get an unreachable level and never arm
+        double min_level = std::numeric_limits<double>::infinity();
+        for (std::size_t l = 0; l < LANES; ++l) {
+            level_[l] = l < lanes ? previous_day_close * (1.0 + gap_thresholds[l])
+                                  : std::numeric_limits<double>::infinity();
+            min_level = std::min(min_level, level_[l]);
+            first_low_[l] = 0.0;
+            armed_[l] = 0.0;
+        }
+        
+        const std::size_t first_word = begin / 64;
+        const std::size_t offset = first_word * 64;
+        gap_mask_.resize(maskWords(n));
+        if (!computeGapMask(columns.open.data() + offset, n - offset, min_level,
+                            gap_mask_.data() + first_word)) {
+            return 0;
+        }
+        
+        const double* open = columns.open.data();
+        const double* low = columns.low.data();
+        std::size_t total = 0;
+        std::size_t i = nextSetBit(gap_mask_.data(), begin, n);
+        while (i < n) {
+            LaneStep lane = step(open[i], low[i], ema_slow[i]);
+            for (std::uint32_t fired = lane.fired; fired; fired &= fired - 1) {
+                signals[__builtin_ctz(fired)].push_back(static_cast<std::uint32_t>(i));
+                ++total;
+            }
+            i = lane.armed ? i + 1 : nextSetBit(gap_mask_.data(), i + 1, n);
+        }
+        return total;
+    }
+};
+
+#endif // SIGNAL_SCAN_HPP
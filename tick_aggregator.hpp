@@ -0,0 +1,323 @@
+#ifndef TICK_AGGREGATOR_HPP
+#define TICK_AGGREGATOR_HPP
+
+#include <algorithm>
+#include <cctype>
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include "binary_io.hpp"
+#include "candle_columns.hpp"
+#include "trading_engine.hpp"
+
+/**
+ * @file tick_aggregator.hpp
+ * @brief Tick ingestion: raw trades → OHLCV candles at a fixed interval
+ * 
+ * Lets the engine run directly off tick archives instead of a separate
+ * bar-building job.
+ * 
+ * HOT PATH:
+ * Timestamps are integers (milliseconds since midnight, exchange time).
+ * The current bucket's [start, end) is cached, so an in-order tick costs
+ * one range check plus min/max/add: no division, no string work. Only a
+ * tick that leaves the current bucket pays for the integer division.
+ * 
+ * OUT-OF-ORDER TOLERANCE:
+ * The watermark is the newest tick timestamp seen. A bar stays open until
+ * the watermark is more than `tolerance_ms` past its end; a late tick for
+ * an open bar is folded into it (open/close are chosen by timestamp, not
+ * arrival order), a tick for a closed bar is dropped and counted. Closed
+ * bars are emitted on the next tick that leaves the newest bucket (or on
+ * flush). Buckets with no ticks produce no candle.
+ */
+
+/**
+ * @brief One trade print
+ */
+struct Tick {
+    std::int64_t timestamp_ms;  // Milliseconds since midnight
+    double price;
+    double quantity;
+};
+
+constexpr std::int64_t MS_PER_MINUTE = 60 * 1000;
+
+/**
+ * @class TickAggregator
+ * @brief Builds Candles from ticks with bounded out-of-order tolerance
+ */
+class TickAggregator {
+private:
+    struct Bar {
+        std::int64_t bucket;
+        std::int64_t open_ts;
+        std::int64_t close_ts;
+        double open;
+        double high;
+        double low;
+        double close;
+        double volume;
+        bool active;
+    };
+    
+    std::int64_t interval_ms_;
+    std::int64_t anchor_ms_;
+    std::int64_t tolerance_ms_;
+    
+    std::vector<Bar> ring_;          // tolerance_ms / interval + 2 slots (max open bars)
+    std::int64_t newest_ts_;         // Watermark
+    std::int64_t newest_bucket_;
+    std::int64_t oldest_open_bucket_;
+    bool started_;
+    
+    // Cached range of the newest bucket for the in-order fast path
+    std::int64_t fast_start_;
+    std::int64_t fast_end_;
+    Bar* fast_bar_;
+    
+    std::uint64_t ticks_processed_;
+    std::uint64_t ticks_dropped_;
+    
+    std::int64_t bucketOf(std::int64_t ts) const {
+        std::int64_t offset = ts - anchor_ms_;
+        std::int64_t q = offset / interval_ms_;
+        return q - (offset % interval_ms_ < 0);  // Floor for pre-anchor ticks
+    }
+    
+    Bar& slotOf(std::int64_t bucket) {
+        std::int64_t n = static_cast<std::int64_t>(ring_.size());
+        std::int64_t idx = bucket % n;
+        return ring_[static_cast<std::size_t>(idx < 0 ? idx + n : idx)];
+    }
+    
+    static void fold(Bar& bar, const Tick& tick) {
+        bar.high = tick.price > bar.high ? tick.price : bar.high;
+        bar.low = tick.price < bar.low ? tick.price : bar.low;
+        bar.volume += tick.quantity;
+        // Later-or-equal timestamp wins the close, strictly earlier wins the open
+        bool later = tick.timestamp_ms >= bar.close_ts;
+        bar.close = later ? tick.price : bar.close;
+        bar.close_ts = later ? tick.timestamp_ms : bar.close_ts;
+        bool earlier = tick.timestamp_ms < bar.open_ts;
+        bar.open = earlier ? tick.price : bar.open;
+        bar.open_ts = earlier ? tick.timestamp_ms : bar.open_ts;
+    }
+    
+    static void start(Bar& bar, std::int64_t bucket, const Tick& tick) {
+        bar = Bar{bucket, tick.timestamp_ms, tick.timestamp_ms,
+                  tick.price, tick.price, tick.price, tick.price,
+                  tick.quantity, true};
+    }
+    
+    Candle toCandle(const Bar& bar) const {
+        std::int64_t start_ms = anchor_ms_ + bar.bucket * interval_ms_;
+        return Candle(formatMinuteOfDay(static_cast<int>(start_ms / MS_PER_MINUTE)),
+                      bar.open, bar.high, bar.low, bar.close, bar.volume);
+    }
+    
+    /**
+     * @brief Emit (in bucket order) every open bar older than `bucket`
+     */
+    template <typename Emit>
+    void closeBefore(std::int64_t bucket, Emit& emit) {
+        for (; oldest_open_bucket_ < bucket; ++oldest_open_bucket_) {
+            Bar& bar = slotOf(oldest_open_bucket_);
+            if (bar.active && bar.bucket == oldest_open_bucket_) {
+                bar.active = false;
+                emit(toCandle(bar));
+            }
+        }
+    }
+    
+    template <typename Emit>
+    void slowPath(const Tick& tick, Emit& emit) {
+        const std::int64_t bucket = bucketOf(tick.timestamp_ms);
+        
+        if (!started_) {
+            started_ = true;
+            newest_ts_ = tick.timestamp_ms;
+            newest_bucket_ = bucket;
+            oldest_open_bucket_ = bucketOf(tick.timestamp_ms - tolerance_ms_ - 1);
+        }
+        newest_ts_ = std::max(newest_ts_, tick.timestamp_ms);
+        
+        // Oldest bucket whose end is within tolerance of the watermark
+        const std::int64_t first_open = bucketOf(newest_ts_ - tolerance_ms_ - 1);
+        // Every active bar is <= newest_bucket_, so a long jump stops scanning there
+        closeBefore(std::min(first_open, newest_bucket_ + 1), emit);
+        oldest_open_bucket_ = std::max(oldest_open_bucket_, first_open);
+        
+        if (bucket < oldest_open_bucket_) {
+            ++ticks_dropped_;
+            return;
+        }
+        newest_bucket_ = std::max(newest_bucket_, bucket);
+        
+        Bar& bar = slotOf(bucket);
+        if (bar.active && bar.bucket == bucket) {
+            fold(bar, tick);
+        } else {
+            start(bar, bucket, tick);
+        }
+        
+        if (bucket == newest_bucket_) {
+            fast_start_ = anchor_ms_ + bucket * interval_ms_;
+            fast_end_ = fast_start_ + interval_ms_;
+            fast_bar_ = &bar;
+        }
+    }
+    
+public:
+    /**
+     * @param interval_minutes Candle interval
+     * @param tolerance_ms How far the watermark may pass a bar's end before it closes
+     * @param anchor_minute Bucket alignment (session open, 09:15 by default)
+     */
+    explicit TickAggregator(int interval_minutes = 5, std::int64_t tolerance_ms = 0,
+                            int anchor_minute = 9 * 60 + 15)
+        : interval_ms_(static_cast<std::int64_t>(interval_minutes) * MS_PER_MINUTE),
+          anchor_ms_(static_cast<std::int64_t>(anchor_minute) * MS_PER_MINUTE),
+          tolerance_ms_(tolerance_ms),
+          newest_ts_(0),
+          newest_bucket_(0),
+          oldest_open_bucket_(0),
+          started_(false),
+          fast_start_(0),
+          fast_end_(0),
+          fast_bar_(nullptr),
+          ticks_processed_(0),
+          ticks_dropped_(0) {
+        if (interval_minutes <= 0 || tolerance_ms < 0) {
+            throw std::invalid_argument("Invalid tick aggregation interval or tolerance");
+        }
+        ring_.assign(static_cast<std::size_t>(tolerance_ms / interval_ms_ + 2), Bar{});
+    }
+    
+    /**
+     * @brief Ingest one tick
+     * @param emit Called with each completed Candle, in time order
+     */
+    template <typename Emit>
+    void onTick(const Tick& tick, Emit&& emit) {
+        ++ticks_processed_;
+        if (tick.timestamp_ms >= fast_start_ && tick.timestamp_ms < fast_end_) {
+            fold(*fast_bar_, tick);
+            newest_ts_ = tick.timestamp_ms > newest_ts_ ? tick.timestamp_ms : newest_ts_;
+            return;
+        }
+        slowPath(tick, emit);
+    }
+    
+    /**
+     * @brief Ingest a contiguous block of ticks
+     */
+    template <typename Emit>
+    void onTicks(const Tick* ticks, std::size_t n, Emit&& emit) {
+        for (std::size_t i = 0; i < n; ++i) onTick(ticks[i], emit);
+    }
+    
+    /**
+     * @brief Close every open bar (end of session)
+     */
+    template <typename Emit>
+    void flush(Emit&& emit) {
+        if (!started_) return;
+        closeBefore(newest_bucket_ + 1, emit);
+        fast_start_ = fast_end_ = 0;
+        fast_bar_ = nullptr;
+    }
+    
+    std::uint64_t getTicksProcessed() const { return ticks_processed_; }
+    std::uint64_t getTicksDropped() const { return ticks_dropped_; }
+};
+
+
+// ============================================================================
+// TICK ARCHIVES
+// ============================================================================
+
+/**
+ * @brief Load ticks from CSV: timestamp_ms,price,quantity (header optional)
+ */
+inline std::vector<Tick> loadTicksCSV(const std::string& filename) {
+    std::ifstream file(filename);
+    if (!file.is_open()) {
+        throw std::runtime_error("Cannot open file: " + filename);
+    }
+    
+    std::vector<Tick> ticks;
+    std::string line;
+    while (std::getline(file, line)) {
+        if (line.empty() || !(std::isdigit(static_cast<unsigned char>(line[0])) ||
+                              line[0] == '-')) {
+            continue;  // Header or blank
+        }
+        long long ts = 0;
+        Tick tick{0, 0, 0};
+        if (std::sscanf(line.c_str(), "%lld,%lf,%lf", &ts, &tick.price, &tick.quantity) != 3) {
+            throw std::runtime_error("Malformed tick line: " + line);
+        }
+        tick.timestamp_ms = ts;
+        ticks.push_back(tick);
+    }
+    return ticks;
+}
+
+/**
+ * @brief Binary archive: u64 count followed by packed (i64, f64, f64) records
+ * 
+ * Loads with a single read, avoiding text parsing on large archives.
+ */
+inline void saveTicksBinary(const std::string& filename, const std::vector<Tick>& ticks) {
+    BinaryWriter out;
+    out.write(static_cast<std::uint64_t>(ticks.size()));
+    for (const auto& tick : ticks) {
+        out.write(tick.timestamp_ms);
+        out.write(tick.price);
+        out.write(tick.quantity);
+    }
+    writeBinaryFile(filename, out.data());
+}
+
+inline std::vector<Tick> loadTicksBinary(const std::string& filename) {
+    std::string buffer = readBinaryFile(filename);
+    BinaryReader in(buffer);
+    constexpr std::size_t RECORD_BYTES = sizeof(std::int64_t) + 2 * sizeof(double);
+    std::vector<Tick> ticks(in.readCount<std::uint64_t>(RECORD_BYTES));
+    for (auto& tick : ticks) {
+        tick.timestamp_ms = in.read<std::int64_t>();
+        tick.price = in.read<double>();
+        tick.quantity = in.read<double>();
+    }
+    return ticks;
+}
+
+/**
+ * @brief Build a session's MarketData straight from ticks
+ * @param ticks_dropped Optional output: late ticks the aggregator dropped
+ */
+inline MarketData buildMarketDataFromTicks(const std::vector<Tick>& ticks,
+                                           const std::string& instrument,
+                                           double previous_day_close, double capital,
+                                           int interval_minutes = 5,
+                                           std::int64_t tolerance_ms = 0,
+                                           std::uint64_t* ticks_dropped = nullptr) {
+    MarketData data;
+    data.instrument = instrument;
+    data.previous_day_close = previous_day_close;
+    data.capital = capital;
+    
+    TickAggregator aggregator(interval_minutes, tolerance_ms);
+    auto emit = [&data](const Candle& candle) { data.candles.push_back(candle); };
+    aggregator.onTicks(ticks.data(), ticks.size(), emit);
+    aggregator.flush(emit);
+    if (ticks_dropped) *ticks_dropped = aggregator.getTicksDropped();
+    return data;
+}
+
+#endif // TICK_AGGREGATOR_HPP
@@ -3,11 +3,20 @@
 
 #include <string>
 #include <vector>
+#include <algorithm>
+#include <map>
+#include <tuple>
+#include <type_traits>
+#include <utility>
 #include <memory>
 #include <ctime>
 #include <iomanip>
+#include <iostream>
 #include <sstream>
+#include <stdexcept>
 #include <cmath>
+#include "pre_trade.hpp"
+#include "rolling_window.hpp"
 
 // ============================================================================
 // CORE DATA STRUCTURES
@@ -26,11 +35,12 @@ struct Candle {
     double high;
     double low;
     double close;
+    double volume;  // Traded quantity (0 when the source has none)
     
-    Candle() : open(0), high(0), low(0), close(0) {}
+    Candle() : open(0), high(0), low(0), close(0), volume(0) {}
     
-    Candle(const std::string& ts, double o, double h, double l, double c)
-        : timestamp(ts), open(o), high(h), low(l), close(c) {}
+    Candle(const std::string& ts, double o, double h, double l, double c, double v = 0)
+        : timestamp(ts), open(o), high(h), low(l), close(c), volume(v) {}
 };
 
 /**
@@ -117,6 +127,7 @@ struct Position {
  */
 struct MarketData {
     std::string instrument;
+    std::string session;  // Trading date / session id (optional in JSON)
     double previous_day_close;
     double capital;
     std::vector<Candle> candles;
@@ -169,6 +180,213 @@ public:
     double getValue() const { return ema_; }
     bool isInitialized() const { return initialized_; }
     void reset() { ema_ = 0.0; initialized_ = false; }
+    
+    /**
+     * @brief Snapshot of the running EMA (see checkpoint.hpp)
+     */
+    struct State {
+        int period;
+        double ema;
+        bool initialized;
+    };
+    
+    State getState() const { return State{period_, ema_, initialized_}; }
+    
+    void restoreState(const State& state) {
+        if (state.period != period_) {
+            throw std::invalid_argument("EMA state period mismatch");
+        }
+        ema_ = state.ema;
+        initialized_ = state.initialized;
+    }
+};
+
+
+// ============================================================================
+// SHARED INDICATOR REGISTRY
+// ============================================================================
+
+/**
+ * @brief Candle field an indicator is computed from
+ */
+enum class PriceSource { OPEN, HIGH, LOW, CLOSE };
+
+/**
+ * @brief Indicator kinds the registry can compute
+ * 
+ * ROLLING_MIN / ROLLING_MAX are lookback extremes over the `period` values
+ * before the current candle (monotonic deque, see rolling_window.hpp), so
+ * "low < lowest(n)" can break the N-bar low. They are ready once `period`
+ * earlier values have been seen.
+ */
+enum class IndicatorType { EMA, ROLLING_MIN, ROLLING_MAX };
+
+inline double selectPrice(const Candle& candle, PriceSource source) {
+    switch (source) {
+        case PriceSource::OPEN:  return candle.open;
+        case PriceSource::HIGH:  return candle.high;
+        case PriceSource::LOW:   return candle.low;
+        case PriceSource::CLOSE: return candle.close;
+    }
+    return candle.close;
+}
+
+using IndicatorHandle = std::size_t;
+
+/**
+ * @class IndicatorRegistry
+ * @brief Deduplicated indicator graph shared by many strategies
+ * 
+ * Strategies request indicators by (type, period, source) and receive a
+ * handle. Identical requests resolve to the same node, so 50 strategy
+ * variants asking for EMA(5) on close share one calculator. An indicator
+ * may also take another indicator as its input (e.g. EMA of EMA); inputs
+ * must already be registered, so registration order is a valid
+ * topological order and update() is a single forward pass.
+ * 
+ * Per-candle cost: O(unique indicators), independent of strategy count.
+ */
+class IndicatorRegistry {
+private:
+    static constexpr IndicatorHandle NO_INPUT = static_cast<IndicatorHandle>(-1);
+    
+    struct Node {
+        IndicatorType type;
+        int period;
+        PriceSource source;
+        IndicatorHandle input;  // Upstream node, or NO_INPUT for raw prices
+        EMACalculator ema;
+        RollingExtreme window;  // Single slot unless a rolling type
+        double pending;         // Rolling types: current input, enters the window next candle
+        bool has_pending;
+        
+        Node(IndicatorType t, int p, PriceSource s, IndicatorHandle in)
+            : type(t), period(p), source(s), input(in), ema(p),
+              window(t == IndicatorType::EMA ? 1 : static_cast<std::size_t>(p),
+                     t == IndicatorType::ROLLING_MAX ? Extreme::MAX : Extreme::MIN),
+              pending(0.0), has_pending(false) {}
+        
+        void update(double x) {
+            if (type == IndicatorType::EMA) {
+                ema.update(x);
+            } else {
+                // Window lags one candle: value() excludes the current input
+                if (has_pending) window.update(pending);
+                pending = x;
+                has_pending = true;
+            }
+        }
+        
+        void reset() {
+            ema.reset();
+            window.reset();
+            pending = 0.0;
+            has_pending = false;
+        }
+        
+        double value() const {
+            return type == IndicatorType::EMA ? ema.getValue() : window.getValue();
+        }
+        
+        bool isReady() const {
+            return type == IndicatorType::EMA ? ema.isInitialized() : window.isReady();
+        }
+    };
+    
+    using Key = std::tuple<int, int, int, IndicatorHandle>;
+    
+    std::vector<Node> nodes_;
+    std::map<Key, IndicatorHandle> index_;
+    
+    IndicatorHandle intern(IndicatorType type, int period, PriceSource source,
+                           IndicatorHandle input) {
+        if (period <= 0) {
+            throw std::invalid_argument("Indicator period must be positive");
+        }
+        
+        Key key(static_cast<int>(type), period, static_cast<int>(source), input);
+        auto it = index_.find(key);
+        if (it != index_.end()) return it->second;
+        
+        IndicatorHandle handle = nodes_.size();
+        nodes_.emplace_back(type, period, source, input);
+        index_.emplace(key, handle);
+        return handle;
+    }
+    
+public:
+    /**
+     * @brief Request an indicator over a raw candle field
+     * @return Handle shared by every identical request
+     */
+    IndicatorHandle request(IndicatorType type, int period,
+                            PriceSource source = PriceSource::CLOSE) {
+        return intern(type, period, source, NO_INPUT);
+    }
+    
+    /**
+     * @brief Request an indicator computed on another indicator's output
+     */
+    IndicatorHandle requestOn(IndicatorType type, int period, IndicatorHandle input) {
+        if (input >= nodes_.size()) {
+            throw std::out_of_range("Unknown input indicator handle");
+        }
+        return intern(type, period, PriceSource::CLOSE, input);
+    }
+    
+    /**
+     * @brief Advance every unique indicator by one candle, in topological order
+     */
+    void update(const Candle& candle) {
+        for (auto& node : nodes_) {
+            double x = node.input == NO_INPUT
+                ? selectPrice(candle, node.source)
+                : nodes_[node.input].value();
+            node.update(x);
+        }
+    }
+    
+    double value(IndicatorHandle handle) const { return nodes_[handle].value(); }
+    bool isReady(IndicatorHandle handle) const { return nodes_[handle].isReady(); }
+    std::size_t size() const { return nodes_.size(); }
+    
+    void reset() {
+        for (auto& node : nodes_) node.reset();
+    }
+    
+    struct NodeState {
+        EMACalculator::State ema;
+        RollingExtreme::State window;
+        double pending;
+        bool has_pending;
+    };
+    
+    /**
+     * @brief Node states in handle order; restore requires the same graph
+     */
+    using State = std::vector<NodeState>;
+    
+    State getState() const {
+        State state;
+        state.reserve(nodes_.size());
+        for (const auto& node : nodes_) {
+            state.push_back(NodeState{node.ema.getState(), node.window.getState(),
+                                      node.pending, node.has_pending});
+        }
+        return state;
+    }
+    
+    void restoreState(const State& state) {
+        if (state.size() != nodes_.size()) {
+            throw std::invalid_argument("Indicator graph size mismatch");
+        }
+        for (std::size_t i = 0; i < nodes_.size(); ++i) {
+            nodes_[i].ema.restoreState(state[i].ema);
+            nodes_[i].window.restoreState(state[i].window);
+            nodes_[i].pending = state[i].pending;
+            nodes_[i].has_pending = state[i].has_pending;
+        }
+    }
 };
 
 
@@ -176,6 +394,18 @@ public:
 // STRATEGY SIGNAL GENERATOR
 // ============================================================================
 
+/**
+ * @brief Tunable strategy parameters (defaults reproduce the original rules)
+ * 
+ * The fast EMA is informational (logged only); entry decisions use the
+ * slow EMA.
+ */
+struct StrategyParams {
+    double gap_threshold = 0.03;  // 3% gap requirement
+    int ema_fast_period = 3;
+    int ema_slow_period = 5;
+};
+
 /**
  * @class TwoCandelPatternStrategy
  * @brief Implements gap-up rejection pattern with EMA filters
@@ -194,7 +424,7 @@ public:
  */
 class TwoCandelPatternStrategy {
 private:
-    const double GAP_THRESHOLD = 0.03;  // 3% gap requirement
+    StrategyParams params_;
     
     Candle first_candle_;
     bool first_candle_valid_;
@@ -203,12 +433,35 @@ private:
     EMACalculator ema3_;
     EMACalculator ema5_;
     
+    // Shared indicators (when attached, the registry owner advances them)
+    const IndicatorRegistry* indicators_;
+    IndicatorHandle ema3_handle_;
+    IndicatorHandle ema5_handle_;
+    
 public:
-    TwoCandelPatternStrategy() 
-        : first_candle_valid_(false),
+    explicit TwoCandelPatternStrategy(const StrategyParams& params = StrategyParams())
+        : params_(params),
+          first_candle_valid_(false),
           previous_day_close_(0),
-          ema3_(3),
-          ema5_(5) {}
+          ema3_(params.ema_fast_period),
+          ema5_(params.ema_slow_period),
+          indicators_(nullptr),
+          ema3_handle_(0),
+          ema5_handle_(0) {}
+    
+    /**
+     * @brief Read EMAs from a shared registry instead of owning them
+     * 
+     * The caller must call registry.update(candle) before processCandle()
+     * for every candle. Variants sharing a registry compute each EMA once.
+     */
+    void attach(IndicatorRegistry& registry) {
+        ema3_handle_ = registry.request(IndicatorType::EMA, params_.ema_fast_period,
+                                        PriceSource::CLOSE);
+        ema5_handle_ = registry.request(IndicatorType::EMA, params_.ema_slow_period,
+                                        PriceSource::CLOSE);
+        indicators_ = &registry;
+    }
     
     void initialize(double prev_close) {
         previous_day_close_ = prev_close;
@@ -228,22 +481,24 @@ public:
      * 3. Generate signal and reset state
      */
     bool processCandle(const Candle& candle) {
-        // Update indicators
-        ema3_.update(candle.close);
-        ema5_.update(candle.close);
+        // Update indicators (shared ones are advanced by the registry owner)
+        if (!indicators_) {
+            ema3_.update(candle.close);
+            ema5_.update(candle.close);
+        }
         
         // Need at least 5 candles for EMA(5) to stabilize
-        if (!ema5_.isInitialized()) {
+        if (!isEMA5Ready()) {
             return false;
         }
         
         // Check for valid first candle
         if (!first_candle_valid_) {
             // Condition 1: Gap-up >= 3%
-            bool gap_condition = candle.open >= previous_day_close_ * (1.0 + GAP_THRESHOLD);
+            bool gap_condition = candle.open >= previous_day_close_ * (1.0 + params_.gap_threshold);
             
             // Condition 2: Low stays above EMA(5)
-            bool ema_condition = candle.low > ema5_.getValue();
+            bool ema_condition = candle.low > getEMA5();
             
             if (gap_condition && ema_condition) {
                 first_candle_ = candle;
@@ -266,9 +521,51 @@ public:
         return false;
     }
     
-    double getEMA3() const { return ema3_.getValue(); }
-    double getEMA5() const { return ema5_.getValue(); }
-    bool isEMA5Ready() const { return ema5_.isInitialized(); }
+    double getEMA3() const {
+        return indicators_ ? indicators_->value(ema3_handle_) : ema3_.getValue();
+    }
+    double getEMA5() const {
+        return indicators_ ? indicators_->value(ema5_handle_) : ema5_.getValue();
+    }
+    bool isEMA5Ready() const {
+        return indicators_ ? indicators_->isReady(ema5_handle_) : ema5_.isInitialized();
+    }
+    
+    // Engine strategy interface (see is_strategy)
+    bool isReady() const { return isEMA5Ready(); }
+    
+    void logIndicators(std::ostream& os) const {
+        os << "EMA" << params_.ema_fast_period << ":" << getEMA3() << " "
+           << "EMA" << params_.ema_slow_period << ":" << getEMA5();
+    }
+    
+    const char* getSignalName() const { return "Two-Candle Pattern Breakdown"; }
+    
+    const StrategyParams& getParams() const { return params_; }
+    
+    /**
+     * @brief Pattern state plus owned EMAs (shared EMAs belong to the registry)
+     */
+    struct State {
+        Candle first_candle;
+        bool first_candle_valid;
+        double previous_day_close;
+        EMACalculator::State ema3;
+        EMACalculator::State ema5;
+    };
+    
+    State getState() const {
+        return State{first_candle_, first_candle_valid_, previous_day_close_,
+                     ema3_.getState(), ema5_.getState()};
+    }
+    
+    void restoreState(const State& state) {
+        first_candle_ = state.first_candle;
+        first_candle_valid_ = state.first_candle_valid;
+        previous_day_close_ = state.previous_day_close;
+        ema3_.restoreState(state.ema3);
+        ema5_.restoreState(state.ema5);
+    }
 };
 
 
@@ -276,6 +573,16 @@ public:
 // RISK MANAGEMENT ENGINE
 // ============================================================================
 
+/**
+ * @brief Tunable risk limits (defaults reproduce the original model)
+ */
+struct RiskParams {
+    double stop_loss_pct = 0.02;    // 2% capital stop
+    double take_profit_pct = 0.07;  // 7% capital target
+    int max_daily_trades = 2;
+    int market_close_minute = 15 * 60;  // Square-off time, minutes since midnight
+};
+
 /**
  * @class RiskManager
  * @brief Capital-based risk control and position sizing
@@ -291,9 +598,7 @@ public:
  */
 class RiskManager {
 private:
-    const double STOP_LOSS_PCT = 0.02;   // 2% capital stop
-    const double TAKE_PROFIT_PCT = 0.07; // 7% capital target
-    const int MAX_DAILY_TRADES = 2;
+    RiskParams params_;
     
     double initial_capital_;
     double current_capital_;
@@ -303,13 +608,14 @@ private:
     double take_profit_amount_;
     
 public:
-    explicit RiskManager(double capital) 
-        : initial_capital_(capital),
+    explicit RiskManager(double capital, const RiskParams& params = RiskParams()) 
+        : params_(params),
+          initial_capital_(capital),
           current_capital_(capital),
           trades_today_(0) {
         
-        stop_loss_amount_ = initial_capital_ * STOP_LOSS_PCT;
-        take_profit_amount_ = initial_capital_ * TAKE_PROFIT_PCT;
+        stop_loss_amount_ = initial_capital_ * params_.stop_loss_pct;
+        take_profit_amount_ = initial_capital_ * params_.take_profit_pct;
     }
     
     /**
@@ -326,7 +632,7 @@ public:
     }
     
     bool canTrade() const {
-        return trades_today_ < MAX_DAILY_TRADES;
+        return trades_today_ < params_.max_daily_trades;
     }
     
     void recordTrade() {
@@ -361,6 +667,174 @@ public:
     
     double getStopLossAmount() const { return stop_loss_amount_; }
     double getTakeProfitAmount() const { return take_profit_amount_; }
+    const RiskParams& getParams() const { return params_; }
+    int getMarketCloseMinute() const { return params_.market_close_minute; }
+    
+    /**
+     * @brief Mutable risk state; limits are derived from initial capital
+     */
+    struct State {
+        double current_capital;
+        int trades_today;
+    };
+    
+    State getState() const { return State{current_capital_, trades_today_}; }
+    
+    void restoreState(const State& state) {
+        current_capital_ = state.current_capital;
+        trades_today_ = state.trades_today;
+    }
+};
+
+
+// ============================================================================
+// STRATEGY AND RISK INTERFACES
+// ============================================================================
+
+/**
+ * @brief Compile-time check that S can drive TradingEngine
+ * 
+ * Required members:
+ *   void initialize(double prev_close);
+ *   bool processCandle(const Candle&);
+ *   bool isReady() const;                    // Indicators warmed up
+ *   void logIndicators(std::ostream&) const;  // Candle log suffix
+ *   const char* getSignalName() const;
+ * Optional:
+ *   void attach(IndicatorRegistry&);         // Use engine-owned indicators
+ */
+template <typename S, typename = void>
+struct is_strategy : std::false_type {};
+
+template <typename S>
+struct is_strategy<S, std::void_t<
+    decltype(std::declval<S&>().initialize(0.0)),
+    decltype(static_cast<bool>(std::declval<S&>().processCandle(std::declval<const Candle&>()))),
+    decltype(static_cast<bool>(std::declval<const S&>().isReady())),
+    decltype(std::declval<const S&>().logIndicators(std::declval<std::ostream&>())),
+    decltype(std::declval<const S&>().getSignalName())>> : std::true_type {};
+
+template <typename S>
+constexpr bool is_strategy_v = is_strategy<S>::value;
+
+template <typename S, typename = void>
+struct has_indicator_attach : std::false_type {};
+
+template <typename S>
+struct has_indicator_attach<S, std::void_t<
+    decltype(std::declval<S&>().attach(std::declval<IndicatorRegistry&>()))>> : std::true_type {};
+
+/**
+ * @brief Compile-time check that R can gate and size TradingEngine orders
+ * 
+ * Mirrors RiskManager's public interface: construction from capital,
+ * canTrade/recordTrade, calculatePositionSize, SL/TP tests on unrealized
+ * PnL, updateCapital and the reporting getters.
+ */
+template <typename R, typename = void>
+struct is_risk_model : std::false_type {};
+
+template <typename R>
+struct is_risk_model<R, std::void_t<
+    decltype(R(0.0)),
+    decltype(static_cast<bool>(std::declval<const R&>().canTrade())),
+    decltype(std::declval<R&>().recordTrade()),
+    decltype(static_cast<int>(std::declval<const R&>().calculatePositionSize(0.0))),
+    decltype(static_cast<bool>(std::declval<const R&>().isStopLossHit(0.0))),
+    decltype(static_cast<bool>(std::declval<const R&>().isTakeProfitHit(0.0))),
+    decltype(std::declval<R&>().updateCapital(0.0)),
+    decltype(static_cast<double>(std::declval<const R&>().getCurrentCapital())),
+    decltype(static_cast<double>(std::declval<const R&>().getInitialCapital())),
+    decltype(static_cast<double>(std::declval<const R&>().getTotalPnL())),
+    decltype(static_cast<double>(std::declval<const R&>().getTotalPnLPercent())),
+    decltype(static_cast<int>(std::declval<const R&>().getTradesCount())),
+    decltype(static_cast<double>(std::declval<const R&>().getStopLossAmount())),
+    decltype(static_cast<double>(std::declval<const R&>().getTakeProfitAmount()))>>
+    : std::true_type {};
+
+template <typename R>
+constexpr bool is_risk_model_v = is_risk_model<R>::value;
+
+/**
+ * @brief Optional risk hook: bool reserveOrder(price, qty) after sizing
+ * 
+ * Lets a risk model refuse a sized order against limits it shares with
+ * other engines (see PortfolioRiskManager).
+ */
+template <typename R, typename = void>
+struct has_order_reservation : std::false_type {};
+
+template <typename R>
+struct has_order_reservation<R, std::void_t<
+    decltype(static_cast<bool>(std::declval<R&>().reserveOrder(0.0, 0)))>> : std::true_type {};
+
+/**
+ * @brief Optional risk hook: int getMarketCloseMinute() for the square-off time
+ * 
+ * Risk models without it square off at 15:00.
+ */
+template <typename R, typename = void>
+struct has_market_close : std::false_type {};
+
+template <typename R>
+struct has_market_close<R, std::void_t<
+    decltype(static_cast<int>(std::declval<const R&>().getMarketCloseMinute()))>> : std::true_type {};
+
+/**
+ * @class AnyStrategy
+ * @brief Type-erased strategy for runtime selection
+ * 
+ * TradingEngine<AnyStrategy> picks the strategy at runtime (config file,
+ * command line) at the cost of one virtual call per candle. Use the
+ * concrete type as the template argument when speed matters more.
+ */
+class AnyStrategy {
+private:
+    struct Concept {
+        virtual ~Concept() = default;
+        virtual void initialize(double prev_close) = 0;
+        virtual bool processCandle(const Candle& candle) = 0;
+        virtual bool isReady() const = 0;
+        virtual void logIndicators(std::ostream& os) const = 0;
+        virtual const char* getSignalName() const = 0;
+        virtual void attach(IndicatorRegistry& registry) = 0;
+    };
+    
+    template <typename S>
+    struct Model final : Concept {
+        S strategy;
+        
+        explicit Model(S s) : strategy(std::move(s)) {}
+        
+        void initialize(double prev_close) override { strategy.initialize(prev_close); }
+        bool processCandle(const Candle& candle) override { return strategy.processCandle(candle); }
+        bool isReady() const override { return strategy.isReady(); }
+        void logIndicators(std::ostream& os) const override { strategy.logIndicators(os); }
+        const char* getSignalName() const override { return strategy.getSignalName(); }
+        
+        void attach(IndicatorRegistry& registry) override {
+            if constexpr (has_indicator_attach<S>::value) {
+                strategy.attach(registry);
+            } else {
+                (void)registry;
+            }
+        }
+    };
+    
+    std::unique_ptr<Concept> impl_;
+    
+public:
+    template <typename S, typename = std::enable_if_t<
+        !std::is_same<std::decay_t<S>, AnyStrategy>::value && is_strategy_v<std::decay_t<S>>>>
+    AnyStrategy(S strategy)
+        : impl_(std::make_unique<Model<std::decay_t<S>>>(std::move(strategy))) {}
+    
+    void initialize(double prev_close) { impl_->initialize(prev_close); }
+    bool processCandle(const Candle& candle) { return impl_->processCandle(candle); }
+    bool isReady() const { return impl_->isReady(); }
+    void logIndicators(std::ostream& os) const { impl_->logIndicators(os); }
+    const char* getSignalName() const { return impl_->getSignalName(); }
+    void attach(IndicatorRegistry& registry) { impl_->attach(registry); }
 };
 
 
@@ -375,22 +849,35 @@ public:
  * Orchestrates all components in proper sequence:
  * Market Data → Indicators → Strategy → Risk → Execution → PnL
  * 
+ * Indicators live in an IndicatorRegistry owned by the engine and are
+ * advanced once per candle before the strategy reads them by handle.
+ * 
+ * Strategy and Risk are template parameters (statically dispatched), so
+ * processCandle() and the risk checks inline into the run loop. Use
+ * AnyStrategy as the Strategy argument for runtime selection.
+ * 
  * Designed for single-threaded deterministic execution (critical for backtesting
  * and regulatory reproducibility).
  */
+template <typename Strategy = TwoCandelPatternStrategy, typename Risk = RiskManager>
 class TradingEngine {
+    static_assert(is_strategy_v<Strategy>, "Strategy does not satisfy is_strategy");
+    static_assert(is_risk_model_v<Risk>, "Risk does not satisfy is_risk_model");
+    
 private:
     MarketData market_data_;
-    TwoCandelPatternStrategy strategy_;
-    RiskManager risk_manager_;
+    IndicatorRegistry indicators_;
+    Strategy strategy_;
+    Risk risk_manager_;
     Position position_;
+    PreTradePipeline pre_trade_ = PreTradePipeline::withDefaultRules();
     std::vector<Trade> trade_log_;
     
     size_t current_candle_index_;
     bool session_active_;
     
     // Time-based controls
-    const std::string MARKET_CLOSE_TIME = "15:00";
+    static constexpr int DEFAULT_MARKET_CLOSE_MINUTE = 15 * 60;
     
     /**
      * @brief Parse time string to minutes since market open
@@ -401,32 +888,47 @@ private:
         return hours * 60 + minutes;
     }
     
+    int marketCloseMinute() const {
+        if constexpr (has_market_close<Risk>::value) {
+            return risk_manager_.getMarketCloseMinute();
+        } else {
+            return DEFAULT_MARKET_CLOSE_MINUTE;
+        }
+    }
+    
     bool isPastMarketClose(const std::string& current_time) const {
-        return parseTimeToMinutes(current_time) >= parseTimeToMinutes(MARKET_CLOSE_TIME);
+        return parseTimeToMinutes(current_time) >= marketCloseMinute();
+    }
+    
+    std::string marketCloseLabel() const {
+        const int minute = marketCloseMinute();
+        std::ostringstream label;
+        label << "Market Close (" << std::setfill('0') << std::setw(2) << minute / 60
+              << ':' << std::setw(2) << minute % 60 << ')';
+        return label.str();
     }
     
     /**
      * @brief Execute sell order (strategy only generates SELL signals)
      */
     void executeSellOrder(const Candle& candle) {
-        if (!risk_manager_.canTrade()) {
-            logMessage("Trade limit reached for the day");
-            return;
-        }
-        
-        if (position_.is_open) {
-            logMessage("Position already open - skipping signal");
-            return;
-        }
-        
         double entry_price = candle.close;  // Assume execution at candle close
         int quantity = risk_manager_.calculatePositionSize(entry_price);
         
-        if (quantity <= 0) {
-            logMessage("Insufficient capital for position");
+        PreTradeOrder order{entry_price, quantity, market_data_.previous_day_close,
+                            risk_manager_.canTrade(), position_.is_open};
+        if (const PreTradeRule* rejected = pre_trade_.check(order)) {
+            logMessage(rejected->reject_message);
             return;
         }
         
+        if constexpr (has_order_reservation<Risk>::value) {
+            if (!risk_manager_.reserveOrder(entry_price, quantity)) {
+                logMessage("Portfolio limit reached - skipping signal");
+                return;
+            }
+        }
+        
         // Open position
         position_.open(Trade::Side::SELL, entry_price, quantity, candle.timestamp);
         risk_manager_.recordTrade();
@@ -484,26 +986,32 @@ private:
         
         // Check market close
         if (isPastMarketClose(candle.timestamp)) {
-            closePosition(candle, "Market Close (15:00)");
+            closePosition(candle, marketCloseLabel());
             session_active_ = false;
             return;
         }
     }
     
     // Logging methods
+    std::string formatCapitalPercent(double amount) const {
+        std::ostringstream oss;
+        oss << amount / risk_manager_.getInitialCapital() * 100.0;
+        return oss.str();
+    }
+    
     void logMessage(const std::string& msg) const {
         std::cout << "[INFO] " << msg << std::endl;
     }
     
-    void logCandle(const Candle& candle, double ema3, double ema5) const {
+    void logCandle(const Candle& candle) const {
         std::cout << std::fixed << std::setprecision(2);
         std::cout << "\n[" << candle.timestamp << "] "
                   << "O:" << candle.open << " "
                   << "H:" << candle.high << " "
                   << "L:" << candle.low << " "
-                  << "C:" << candle.close << " | "
-                  << "EMA3:" << ema3 << " "
-                  << "EMA5:" << ema5 << std::endl;
+                  << "C:" << candle.close << " | ";
+        strategy_.logIndicators(std::cout);
+        std::cout << std::endl;
     }
     
     void logTrade(const Trade& trade) const {
@@ -523,41 +1031,89 @@ private:
     }
     
 public:
-    explicit TradingEngine(const MarketData& data)
+    explicit TradingEngine(const MarketData& data, Strategy strategy = Strategy())
         : market_data_(data),
+          strategy_(std::move(strategy)),
           risk_manager_(data.capital),
           current_candle_index_(0),
-          session_active_(true) {}
+          session_active_(true) {
+        if constexpr (has_indicator_attach<Strategy>::value) {
+            strategy_.attach(indicators_);
+        }
+    }
+    
+    /**
+     * @brief Construct with a pre-configured risk model (e.g. custom RiskParams)
+     */
+    TradingEngine(const MarketData& data, Strategy strategy, Risk risk)
+        : market_data_(data),
+          strategy_(std::move(strategy)),
+          risk_manager_(std::move(risk)),
+          current_candle_index_(0),
+          session_active_(true) {
+        if constexpr (has_indicator_attach<Strategy>::value) {
+            strategy_.attach(indicators_);
+        }
+    }
+    
+    // Strategy holds a pointer into indicators_
+    TradingEngine(const TradingEngine&) = delete;
+    TradingEngine& operator=(const TradingEngine&) = delete;
     
     /**
      * @brief Main simulation loop - processes market data tick-by-tick
      */
     void run() {
+        begin();
+        resume();
+    }
+    
+    /**
+     * @brief Reset session state and print the session banner
+     */
+    void begin() {
         printHeader();
         
         // Initialize strategy with previous day close
         strategy_.initialize(market_data_.previous_day_close);
+        indicators_.reset();
+        current_candle_index_ = 0;
+        session_active_ = true;
         
         std::cout << "\n════════════════════════════════════════════════════════════════\n";
         std::cout << "Starting Trading Session for " << market_data_.instrument << std::endl;
         std::cout << "Previous Day Close: ₹" << market_data_.previous_day_close << std::endl;
         std::cout << "Initial Capital: ₹" << risk_manager_.getInitialCapital() << std::endl;
         std::cout << "Stop Loss: ₹" << risk_manager_.getStopLossAmount() 
-                  << " (2% of capital)" << std::endl;
+                  << " (" << formatCapitalPercent(risk_manager_.getStopLossAmount())
+                  << "% of capital)" << std::endl;
         std::cout << "Take Profit: ₹" << risk_manager_.getTakeProfitAmount() 
-                  << " (7% of capital)" << std::endl;
+                  << " (" << formatCapitalPercent(risk_manager_.getTakeProfitAmount())
+                  << "% of capital)" << std::endl;
         std::cout << "════════════════════════════════════════════════════════════════\n";
+    }
+    
+    /**
+     * @brief Process candles up to (excluding) end_index
+     * 
+     * Stops early if the session ends. Together with checkpoint.hpp this lets a
+     * backtest be forked at any candle without recomputing the prefix.
+     */
+    void advanceTo(size_t end_index) {
+        end_index = std::min(end_index, market_data_.candles.size());
         
         // Process each candle
-        for (const auto& candle : market_data_.candles) {
+        while (current_candle_index_ < end_index) {
             if (!session_active_) break;
+            const Candle& candle = market_data_.candles[current_candle_index_++];
             
-            // Update strategy with new candle
+            // Advance shared indicators once, then the strategy reads them
+            indicators_.update(candle);
             bool signal = strategy_.processCandle(candle);
             
             // Log candle data
-            if (strategy_.isEMA5Ready()) {
-                logCandle(candle, strategy_.getEMA3(), strategy_.getEMA5());
+            if (strategy_.isReady()) {
+                logCandle(candle);
             } else {
                 std::cout << "\n[" << candle.timestamp << "] "
                           << "Warming up indicators..." << std::endl;
@@ -568,7 +1124,7 @@ public:
             
             // Process entry signal (if any)
             if (signal && session_active_) {
-                std::cout << "\n*** SIGNAL DETECTED: Two-Candle Pattern Breakdown ***\n";
+                std::cout << "\n*** SIGNAL DETECTED: " << strategy_.getSignalName() << " ***\n";
                 executeSellOrder(candle);
             }
             
@@ -579,7 +1135,20 @@ public:
                           << std::fixed << std::setprecision(2) << unrealized << std::endl;
             }
         }
-        
+    }
+    
+    /**
+     * @brief Continue from the current candle to end of data and report
+     */
+    void resume() {
+        advanceTo(market_data_.candles.size());
+        finish();
+    }
+    
+    /**
+     * @brief Square off at end of data and print the summary
+     */
+    void finish() {
         // Force close any open position at end of data
         if (position_.is_open && !market_data_.candles.empty()) {
             const Candle& last_candle = market_data_.candles.back();
@@ -589,6 +1158,48 @@ public:
         printSummary();
     }
     
+    /**
+     * @brief Complete engine snapshot (see checkpoint.hpp for encoding)
+     */
+    struct State {
+        size_t candle_index;
+        bool session_active;
+        typename Strategy::State strategy;
+        IndicatorRegistry::State indicators;
+        typename Risk::State risk;
+        Position position;
+        std::vector<Trade> trade_log;
+    };
+    
+    State getState() const {
+        return State{current_candle_index_, session_active_, strategy_.getState(),
+                     indicators_.getState(), risk_manager_.getState(),
+                     position_, trade_log_};
+    }
+    
+    void restoreState(const State& state) {
+        if (state.candle_index > market_data_.candles.size()) {
+            throw std::invalid_argument("Checkpoint candle index beyond market data");
+        }
+        current_candle_index_ = state.candle_index;
+        session_active_ = state.session_active;
+        strategy_.restoreState(state.strategy);
+        indicators_.restoreState(state.indicators);
+        risk_manager_.restoreState(state.risk);
+        position_ = state.position;
+        trade_log_ = state.trade_log;
+    }
+    
+    const MarketData& getMarketData() const { return market_data_; }
+    size_t getCandleIndex() const { return current_candle_index_; }
+    const std::vector<Trade>& getTradeLog() const { return trade_log_; }
+    
+    /**
+     * @brief Pre-trade rule table; add rules before run()
+     */
+    PreTradePipeline& getPreTradeChecks() { return pre_trade_; }
+    const PreTradePipeline& getPreTradeChecks() const { return pre_trade_; }
+    
     void printHeader() const {
         std::cout << "\n";
         std::cout << "╔════════════════════════════════════════════════════════════════╗\n";
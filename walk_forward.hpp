@@ -0,0 +1,207 @@
+#ifndef WALK_FORWARD_HPP
+#define WALK_FORWARD_HPP
+
+#include <fstream>
+#include <iomanip>
+#include <numeric>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include "parameter_sweep.hpp"
+
+/**
+ * @file walk_forward.hpp
+ * @brief Rolling in-sample optimisation / out-of-sample validation
+ * 
+ * Sessions are taken in universe order (load files chronologically). Window
+ * w optimises over sessions [w*step, w*step + train) and trades the winner
+ * on the following `test` sessions.
+ * 
+ * REUSE:
+ * In-sample windows overlap heavily, so nothing is computed per window. The
+ * grid is run once over blocks of gcd(train, step) sessions; every in-sample
+ * window is an exact run of consecutive blocks and its statistics are a
+ * merge of block partials. EMA series come from the shared series cache, so
+ * the out-of-sample reruns never recompute an indicator either.
+ * 
+ * Windows are then selected and run out-of-sample in parallel; results do
+ * not depend on the thread count.
+ */
+
+struct WalkForwardSpec {
+    std::size_t train_sessions = 20;
+    std::size_t test_sessions = 5;
+    std::size_t step_sessions = 0;  // 0 = test_sessions (non-overlapping OOS)
+    
+    std::size_t step() const { return step_sessions ? step_sessions : test_sessions; }
+};
+
+struct WalkForwardWindow {
+    std::size_t train_begin = 0;
+    std::size_t train_end = 0;
+    std::size_t test_begin = 0;
+    std::size_t test_end = 0;
+    BacktestConfig best;
+    SweepAccumulator in_sample;
+    SweepAccumulator out_of_sample;
+    std::vector<RunSummary> test_runs;  // Per out-of-sample session
+};
+
+/**
+ * @brief One point of the stitched out-of-sample equity curve
+ */
+struct WalkForwardPoint {
+    std::size_t session = 0;
+    std::size_t window = 0;
+    double pnl = 0.0;
+    double equity = 0.0;  // Cumulative out-of-sample P&L
+};
+
+struct WalkForwardReport {
+    std::vector<WalkForwardWindow> windows;
+    std::vector<WalkForwardPoint> equity;
+    SweepAccumulator out_of_sample;  // Over the stitched sessions only
+    
+    /**
+     * @brief Walk-forward efficiency: OOS P&L per session / IS P&L per session
+     */
+    double efficiency() const {
+        double is_pnl = 0.0;
+        double is_sessions = 0.0;
+        for (const auto& w : windows) {
+            is_pnl += w.in_sample.total_pnl;
+            is_sessions += w.in_sample.sessions;
+        }
+        if (is_sessions == 0 || out_of_sample.sessions == 0 || is_pnl == 0.0) return 0.0;
+        return (out_of_sample.total_pnl / out_of_sample.sessions) / (is_pnl / is_sessions);
+    }
+};
+
+/**
+ * @class WalkForwardOptimizer
+ * @brief Walk-forward analysis of a configuration grid over a MarketUniverse
+ */
+class WalkForwardOptimizer {
+private:
+    const MarketUniverse& universe_;
+    ParameterSweep sweep_;
+    WalkForwardSpec spec_;
+    
+public:
+    WalkForwardOptimizer(const MarketUniverse& universe, IndicatorSeriesCache& cache,
+                         const WalkForwardSpec& spec, unsigned threads = 0)
+        : universe_(universe), sweep_(universe, cache, threads), spec_(spec) {
+        if (spec_.train_sessions == 0 || spec_.test_sessions == 0) {
+            throw std::invalid_argument("Walk-forward train and test lengths must be positive");
+        }
+    }
+    
+    /**
+     * @brief Window boundaries for the current universe (OOS may be truncated at the end)
+     */
+    std::vector<WalkForwardWindow> layout() const {
+        std::vector<WalkForwardWindow> windows;
+        const std::size_t sessions = universe_.size();
+        for (std::size_t begin = 0; begin + spec_.train_sessions < sessions;
+             begin += spec_.step()) {
+            WalkForwardWindow w;
+            w.train_begin = begin;
+            w.train_end = begin + spec_.train_sessions;
+            w.test_begin = w.train_end;
+            w.test_end = std::min(sessions, w.test_begin + spec_.test_sessions);
+            windows.push_back(w);
+        }
+        return windows;
+    }
+    
+    WalkForwardReport run(const std::vector<BacktestConfig>& configs) const {
+        if (configs.empty()) {
+            throw std::invalid_argument("Walk-forward needs at least one configuration");
+        }
+        
+        WalkForwardReport report;
+        report.windows = layout();
+        if (report.windows.empty()) return report;
+        
+        // 1. Whole grid once, over blocks that tile every in-sample window
+        const std::size_t block = std::gcd(spec_.train_sessions, spec_.step());
+        const std::size_t blocks = (universe_.size() + block - 1) / block;
+        const std::size_t train_blocks = spec_.train_sessions / block;
+        std::vector<SweepAccumulator> partials = sweep_.accumulateBlocks(configs, block);
+        
+        // 2. Per window: pick the in-sample winner, then trade it out-of-sample
+        parallelFor(report.windows.size(), sweep_.threadCount(), [&](std::size_t w, unsigned) {
+            WalkForwardWindow& window = report.windows[w];
+            const std::size_t first_block = window.train_begin / block;
+            
+            std::size_t best = 0;
+            for (std::size_t c = 0; c < configs.size(); ++c) {
+                SweepAccumulator stats;
+                for (std::size_t b = first_block; b < first_block + train_blocks; ++b) {
+                    stats.merge(partials[c * blocks + b]);
+                }
+                if (c == 0 || isBetterResult(stats, window.in_sample)) {
+                    best = c;
+                    window.in_sample = stats;
+                }
+            }
+            window.best = configs[best];
+            
+            for (std::size_t s = window.test_begin; s < window.test_end; ++s) {
+                RunSummary run = sweep_.evaluate(window.best, s);
+                window.out_of_sample.add(run);
+                window.test_runs.push_back(run);
+            }
+        });
+        
+        // 3. Stitch: each OOS session is owned by the latest window covering it
+        double equity = 0.0;
+        for (std::size_t w = 0; w < report.windows.size(); ++w) {
+            const WalkForwardWindow& window = report.windows[w];
+            std::size_t end = window.test_end;
+            if (w + 1 < report.windows.size()) {
+                end = std::min(end, report.windows[w + 1].test_begin);
+            }
+            for (std::size_t s = window.test_begin; s < end; ++s) {
+                const RunSummary& run = window.test_runs[s - window.test_begin];
+                equity += run.pnl();
+                report.equity.push_back({s, w, run.pnl(), equity});
+                report.out_of_sample.add(run);
+            }
+        }
+        return report;
+    }
+};
+
+/**
+ * @brief Per-window table: boundaries, chosen parameters, IS and OOS results
+ */
+inline void writeWalkForwardCSV(const std::string& filename, const WalkForwardReport& report) {
+    std::ofstream file(filename);
+    if (!file.is_open()) {
+        throw std::runtime_error("Cannot write file: " + filename);
+    }
+    
+    file << "window,train_begin,train_end,test_begin,test_end,gap_threshold,"
+            "ema_slow_period,stop_loss_pct,take_profit_pct,max_daily_trades,"
+            "market_close_minute,is_pnl,is_trades,is_win_rate,oos_pnl,oos_trades,oos_win_rate,"
+            "oos_equity_drawdown\n";
+    file << std::setprecision(10);
+    for (std::size_t w = 0; w < report.windows.size(); ++w) {
+        const auto& r = report.windows[w];
+        file << w << ',' << r.train_begin << ',' << r.train_end << ','
+             << r.test_begin << ',' << r.test_end << ','
+             << r.best.strategy.gap_threshold << ','
+             << r.best.strategy.ema_slow_period << ','
+             << r.best.risk.stop_loss_pct << ','
+             << r.best.risk.take_profit_pct << ','
+             << r.best.risk.max_daily_trades << ','
+             << r.best.risk.market_close_minute << ','
+             << r.in_sample.total_pnl << ',' << r.in_sample.trades << ','
+             << r.in_sample.winRate() << ','
+             << r.out_of_sample.total_pnl << ',' << r.out_of_sample.trades << ','
+             << r.out_of_sample.winRate() << ',' << r.out_of_sample.equity_drawdown << '\n';
+    }
+}
+
+#endif // WALK_FORWARD_HPP